@@ -17,15 +17,37 @@
 #include "analog.h"
 #include "display.h"
 #include "sound.h"
+#include "sched.h"
+
+//----------------------------- : -----------------------------------
+
+#define AWD_TCONV ((13.5 + 12.5) * 4) //  ,  CPU
 
 //----------------------------------------------------------------------------
 //-----------------------------  TScaler: -------------------------------
 //----------------------------------------------------------------------------
 
 #define SCALE ((1LL << (64 - 16 - 1)) / VMAX) // 
+#define I64_MAX ((int64_t)(~0ULL >> 1)) //  int64_t
+
+//----------------------------- : ---------------------------------
+
+//adc -   (),   ()
+
+TScaler::TScaler(bool adc)
+{
+  for(char i = 0; i < CORR_PTS; i++)
+    Corr[i] = 0;
+  CorrOn = 0;
+  CorrIn = adc;
+  Offset = 0;
+}
 
 //----------      : ----------
 
+//      ,
+//    64- .
+
 void TScaler::Calibrate(uint16_t p1, uint16_t c1,
                         uint16_t p2, uint16_t c2)
 {
@@ -33,28 +55,270 @@ void TScaler::Calibrate(uint16_t p1, uint16_t c1,
   uint16_t dc = c2 - c1;
   Kx = (SCALE * dp + dc / 2) / dc;
   Sx = Kx * c1 - SCALE * p1;
+  RecS.Init(SCALE, 16);
+  RecK.Init(Kx, DAC_RES);
+  NmV = (int64_t)(VMAX + 1) * SCALE;
+  NmC = (Kx < I64_MAX / (DAC_MAX_CODE + 1))?
+    (int64_t)(DAC_MAX_CODE + 1) * Kx : I64_MAX;
 }
 
 //-------------------    : ------------------------
 
 uint16_t TScaler::CodeToValue(uint16_t code)
 {
-  int32_t v = (Kx * code - Sx + SCALE / 2) / SCALE;
-  if(v < 0) v = 0;
-  if(v > VMAX) v = VMAX;
-  return(v);
+  if(Offset) code = Shift(code, -Offset, 0xFFFF);
+  if(CorrOn) code = Correct(code, 0xFFFF);
+  int64_t n = Kx * code - Sx + SCALE / 2;
+  if(n < 0) return(0);
+  if(n >= NmV) return(VMAX);
+  return(RecS.Div(n));
+}
+
+//------------------     : ---------------
+
+uint16_t TScaler::SpanToValue(uint16_t span)
+{
+  int64_t n = Kx * span + SCALE / 2;
+  if(n >= NmV) return(VMAX);
+  return(RecS.Div(n));
 }
 
 //-------------------    : -------------------------
 
 uint16_t TScaler::ValueToCode(uint16_t value)
 {
-  int32_t c = (SCALE * value + Sx + Kx / 2) / Kx;
+  int64_t n = SCALE * value + Sx + Kx / 2;
+  if(n < 0) return(0);
+  if(n >= NmC) return(DAC_MAX_CODE);
+  uint16_t c = RecK.Div(n);
+  if(CorrOn) c = CorrIn? Uncorrect(c) : Correct(c, DAC_MAX_CODE);
+  if(Offset) c = Shift(c, Offset, DAC_MAX_CODE);
+  return(c);
+}
+
+//-----------------     : --------------------
+
+//  ,   CodeToValue() >= value,
+// PROT_OFF,    . CodeToValue    
+//,         ,
+//  .    .
+
+uint32_t TScaler::ValueToTrip(uint16_t value)
+{
+  uint32_t lo = 0;
+  uint32_t hi = 0x10000;
+  while(lo < hi)
+  {
+    uint32_t m = (lo + hi) / 2;
+    if(CodeToValue(m) >= value) hi = m;
+      else lo = m + 1;
+  }
+  return((lo > 0xFFFF)? PROT_OFF : lo);
+}
+
+//--------------------     : ------------------------
+
+int16_t TScaler::Delta(uint16_t code)
+{
+  uint8_t s = code >> CORR_SH;
+  int32_t f = code & ((1 << CORR_SH) - 1);
+  int32_t d = Corr[s] * ((1 << CORR_SH) - f) + Corr[s + 1] * f;
+  return((d + (1 << (CORR_SH - 1))) >> CORR_SH);
+}
+
+//----------------      (DAC_RES): --------------
+
+//   DAC_EXT     
+//  ,      .
+
+uint32_t TScaler::ValueToDac(uint16_t value)
+{
+#if DAC_EXT
+  int64_t n = SCALE * value + Sx;
+  if(n < 0) return(0);
+  if(n >= NmC || n >= (I64_MAX >> (DAC_EXT + 1))) return(DAC_MAX_DITH);
+  n = (n << DAC_EXT) + Kx / 2;
+  uint32_t c = RecK.Div(n);
+  if(CorrOn)
+    c = ((uint32_t)Correct(c >> DAC_EXT, DAC_MAX_CODE) << DAC_EXT) |
+      (c & ((1 << DAC_EXT) - 1));
+  if(c > DAC_MAX_DITH) c = DAC_MAX_DITH;
+  return(c);
+#else
+  return(ValueToCode(value));
+#endif
+}
+
+//-------------     x SCALE  : -------
+
+//     ,  
+// .
+
+int64_t TScaler::CodeToScaled(uint16_t code)
+{
+  if(Offset) code = Shift(code, -Offset, 0xFFFF);
+  if(CorrOn) code = Correct(code, 0xFFFF);
+  return(Kx * code - Sx);
+}
+
+//--------   x SCALE    : --------------
+
+int32_t TScaler::ScaledToCode(int64_t n)
+{
+  n += Sx;
+  if(n < 0) return(-(int32_t)((Kx / 2 - n) / Kx));
+  return((n + Kx / 2) / Kx);
+}
+
+//------------------------  : ---------------------------
+
+//code - 
+//max -    
+
+uint16_t TScaler::Correct(uint16_t code, uint16_t max)
+{
+  return(Shift(code, Delta(code), max));
+}
+
+//------------------    : --------------------
+
+//  x,   Correct(x) = code: x = code - Delta(x).
+
+uint16_t TScaler::Uncorrect(uint16_t code)
+{
+  uint16_t x = code;
+  for(char i = 0; i < 3; i++)
+    x = Shift(code, -Delta(x), 0xFFFF);
+  return(x);
+}
+
+//---------------------------   : -------------------------------
+
+//code - 
+//d - 
+//max -    
+
+uint16_t TScaler::Shift(uint16_t code, int16_t d, uint16_t max)
+{
+  int32_t c = (int32_t)code + d;
   if(c < 0) c = 0;
-  if(c > DAC_MAX_CODE) c = DAC_MAX_CODE;
+  if(c > max) c = max;
   return(c);
 }
 
+//-------------------------   : -------------------------
+
+//       
+// ,    .
+
+void TScaler::SetOffset(int16_t o)
+{
+  Offset = o;
+}
+
+//--------------------------   : ---------------------------
+
+int16_t TScaler::GetOffset(void)
+{
+  return(Offset);
+}
+
+//------------------------   : -----------------------
+
+void TScaler::SetCorr(const int8_t *p)
+{
+  CorrOn = 0;
+  for(char i = 0; i < CORR_PTS; i++)
+  {
+    Corr[i] = p[i];
+    if(p[i]) CorrOn = 1;
+  }
+}
+
+//-------------------------   : --------------------------
+
+int8_t TScaler::GetCorr(char n)
+{
+  return(Corr[n]);
+}
+
+//----------------------------------------------------------------------------
+//-----------------------------  TRecip: --------------------------------
+//----------------------------------------------------------------------------
+
+//------------------    : ------------------
+
+//d - 
+//q -  
+
+void TRecip::Init(uint64_t d, uint8_t q)
+{
+  if(!d) d = 1;
+  D = d;
+  uint8_t b = 0; // 
+  while(b < 64 && (d >> b)) b++;
+  //R = 2^S / D, 2^30 < R <= 2^31:
+  S = 30 + b;
+  if(b <= 32)
+  {
+    R = (1ULL << S) / d;
+  }
+  else
+  {
+    // 32    ,  R :
+    R = (1ULL << 62) / ((d >> (b - 32)) + 1);
+  }
+  // n < 2^(q + b)   32 :
+  A = (b + q > 32)? b + q - 32 : 0;
+}
+
+//------------------   : ------------------------
+
+uint32_t ISqrt(uint64_t x)
+{
+  uint64_t r = 0;
+  uint64_t b = 1ULL << 62;
+  while(b > x) b >>= 2;
+  while(b)
+  {
+    if(x >= r + b)
+    {
+      x -= r + b;
+      r = (r >> 1) + b;
+    }
+    else
+    {
+      r >>= 1;
+    }
+    b >>= 2;
+  }
+  return(r);
+}
+
+//----------------------------------------------------------------------------
+//------------------------------  TFuse: --------------------------------
+//----------------------------------------------------------------------------
+
+//----------------------------- : ---------------------------------
+
+TFuse::TFuse(void)
+{
+  Lim2 = 0;
+  Bound = 0;
+  Acc = 0;
+}
+
+//---------------------------  : ------------------------------
+
+//lim -  , x0.001 
+//b - , x0.01 A^2 (0 - )
+
+void TFuse::Set(uint16_t lim, uint16_t b)
+{
+  Lim2 = (uint32_t)lim * lim;
+  Bound = (uint64_t)b * I2T_UNIT;
+}
+
 //----------------------------------------------------------------------------
 //----------------------------  TAnalog: -------------------------------
 //----------------------------------------------------------------------------
@@ -73,20 +337,96 @@ TAnalog::TAnalog(void)
   AdcI = new TAdc<ADC_CH_I, ADC_PIN_I>();
   DacV = new TDac<DAC_CH_V>();
   DacI = new TDac<DAC_CH_I>();
+  // ,    :
+  RCC->APB1ENR |= RCC_APB1ENR_TIM7EN;
+  RAMP_TIM->PSC = 0;
+  RAMP_TIM->ARR = (SYSTEM_CORE_CLOCK / RAMP_FS) - 1;
+  RAMP_TIM->DIER = TIM_DIER_UIE;
+  NVIC_SetPriority(TIM7_IRQn, RAMP_IRQ_PRI);
+  NVIC_EnableIRQ(TIM7_IRQn);
+#if CAP_ENABLE
+  Capture = new TCapture();
+#endif
+#if SEQ_ENABLE
+  Sequencer = new TSequencer();
+#endif
+#if JRN_ENABLE
+  Journal = new TJournal();
+#endif
+#if CORR_SWEEP
+  SweepSt = SWS_IDLE;
+  SweepPt = 0;
+#endif
+#if ACAL_ENABLE
+  AcalPer = ACAL_PER;
+  AcalDT = ACAL_DT;
+  AcalSec = 0;
+  AcalTemp = TEMP_FAIL;
+  AcalReq = 0;
+  AcalCount = 0;
+  AcalSkips = 0;
+  AcalTime = 0;
+  AcalTimeMax = 0;
+  AcalFactor = ADC1->DR & ADC_CAL_MASK; //  
+  AcalDelta = 0;
+#endif
 
   CCTimer = new TSoftTimer(CVCC_DEL);
   CCTimer->Force();
   CVTimer = new TSoftTimer(CVCC_DEL);
   CVTimer->Force();
 
+#if !ADC_IRQ
   OvpTimer = new TSoftTimer();
   OcpTimer = new TSoftTimer();
+#endif
   OppTimer = new TSoftTimer();
+  Fuse = new TFuse();
   ProtSt = PR_OK;
+  ProtDirty = 1;
+#if ADC_IRQ
+  ProtTrip = 0;
+  ProtDnp = 0;
+  ProtSegs = 0;
+  OvpCode = PROT_OFF;
+  OcpCode = PROT_OFF;
+  ProtTrips = 0;
+  ProtLatency = 0;
+  ProtLatencyMax = 0;
+  NVIC_SetPriority(DMA1_Channel7_IRQn, PROT_IRQ_PRI);
+  NVIC_EnableIRQ(DMA1_Channel7_IRQn);
+  //    TIM2 TRGO (ITR1),  
+  //      TIM2:
+  RCC->APB1ENR |= RCC_APB1ENR_TIM4EN;
+  PROT_TIM->PSC = 0;
+  PROT_TIM->ARR = PROT_SEG - 1;
+  PROT_TIM->SMCR =
+    TIM_SMCR_TS_0      * 1 |          //trigger - ITR1 (TIM2 TRGO)
+    TIM_SMCR_SMS_0     * 7;           //external clock mode 1
+  TIM2->CR1 &= ~TIM_CR1_CEN;
+  uint16_t n = ADC_BUFF - DMA1_Channel7->CNDTR;
+  PROT_TIM->CNT = n % PROT_SEG;
+  ProtSeg = n / PROT_SEG % (ADC_BUFF / PROT_SEG);
+  PROT_TIM->SR = 0;
+  PROT_TIM->DIER = TIM_DIER_UIE;
+  PROT_TIM->CR1 = TIM_CR1_CEN;
+  TIM2->CR1 |= TIM_CR1_CEN;
+  NVIC_SetPriority(PROT_IRQN, PROT_IRQ_PRI);
+  NVIC_EnableIRQ(PROT_IRQN);
+#endif
+#if AWD_PROT
+  AwdTrip = 0;
+  AwdTrips = 0;
+  AwdLatency = 0;
+  AwdLatencyMax = 0;
+  NVIC_SetPriority(ADC1_IRQn, 0);
+  NVIC_EnableIRQ(ADC1_IRQn);
+#endif
 
   CvCcSt = PS_UNREG;
   CvCcPre = PS_UNREG;
   Out = 0;
+  EnergyReset();
 
   OutBlinkTimer = new TSoftTimer();
   OutBlinkTimer->Oneshot = 1;
@@ -120,6 +460,188 @@ TAnalog::TAnalog(void)
   DacI->SetZero(ZI_VAL);
 }
 
+//---------------------   : ---------------------------
+
+//    TData,      EEPROM.
+//    ,    .
+//   ,     RAM.
+
+void TAnalog::InitCorr(void)
+{
+#if CORR_EEPROM
+  uint8_t e = TEeprom::Error;
+  CorrData = new TCrcSection(CORR_WORDS);
+  if(!CorrData->Valid)
+  {
+    if(TEeprom::Error & ER_ALLOC) CorrData = 0;
+    TEeprom::Error = e | (TEeprom::Error & ER_ALLOC);
+    return;
+  }
+  int8_t p[CORR_WORDS * 2];
+  for(char i = 0; i < CORR_WORDS; i++)
+  {
+    uint16_t w = CorrData->Read(i);
+    p[i * 2] = LO(w);
+    p[i * 2 + 1] = HI(w);
+  }
+  for(char ch = 0; ch < CORR_CH; ch++)
+    Scaler(ch)->SetCorr(p + ch * CORR_PTS);
+  ProtDirty = 1;
+#endif
+}
+
+//---------------------   : ------------------------
+
+// false,      RAM.
+
+bool TAnalog::SaveCorr(char ch)
+{
+#if CORR_EEPROM
+  if(!CorrData) return(0);
+  //      :
+  if(!CorrData->Valid)
+    for(char i = 0; i < CORR_WORDS; i++)
+      CorrData->Update(i, 0);
+  //   b..b + CORR_PTS - 1,  
+  //   :
+  TScaler *s = Scaler(ch);
+  uint8_t b = ch * CORR_PTS;
+  for(uint8_t i = b / 2; i <= (b + CORR_PTS - 1) / 2; i++)
+  {
+    uint16_t w = CorrData->Read(i);
+    uint8_t l = (i * 2 >= b)? s->GetCorr(i * 2 - b) : LO(w);
+    uint8_t h = (i * 2 + 1 < b + CORR_PTS)? s->GetCorr(i * 2 + 1 - b) : HI(w);
+    CorrData->Update(i, WORD(h, l));
+  }
+  CorrData->Validate();
+  return(1);
+#else
+  (void)ch;
+  return(0);
+#endif
+}
+
+//-------------------------    : -------------------------
+
+TScaler *TAnalog::Scaler(char ch)
+{
+  if(ch == CORR_DV) return(DacV);
+  if(ch == CORR_DI) return(DacI);
+  if(ch == CORR_AV) return(AdcV);
+  return(AdcI);
+}
+
+//--------------------    : -------------------------
+
+#if CORR_SWEEP
+
+//ch -  CORR_DV  CORR_DI.
+//   ,   I   ( 
+// ).     ,  
+// ,     .
+
+bool TAnalog::SweepStart(char ch)
+{
+  if(ch > CORR_DI || !Out || SweepSt == SWS_RUN) return(0);
+#if SEQ_ENABLE
+  Sequencer->Stop();
+#endif
+  DacV->SetRate(0);
+  DacI->SetRate(0);
+  SweepCh = ch;
+  SweepMask = 0;
+  SweepPt = 0;
+  SweepSt = SWS_RUN;
+  if(!SweepPoint()) SweepEnd(SWS_FAIL);
+  return(1);
+}
+
+//-------------------------   : --------------------------
+
+void TAnalog::SweepStop(void)
+{
+  if(SweepSt == SWS_RUN) SweepEnd(SWS_IDLE);
+}
+
+//----------------------     : -------------------------
+
+// false,      MAXV/MAXI.
+
+bool TAnalog::SweepPoint(void)
+{
+  uint32_t c = (uint32_t)SweepPt << CORR_SH;
+  if(c > DAC_MAX_CODE) c = DAC_MAX_CODE;
+  char p = (SweepCh == CORR_DV)? PAR_MAXV : PAR_MAXI;
+  if(Scaler(SweepCh)->CodeToValue(c) > Data->TopData->Items[p]->Value)
+    return(0);
+  if(SweepCh == CORR_DV) DacV->SetCode(c);
+    else DacI->SetCode(c);
+  SweepCnt = 0;
+  SweepAcc = 0;
+  return(1);
+}
+
+//------------------    (  ): --------------------
+
+inline void TAnalog::SweepControl(void)
+{
+  if(SweepSt != SWS_RUN || !AdcI->FastUpdate) return;
+  if(!Out) { SweepEnd(SWS_FAIL); return; }
+  if(++SweepCnt <= SWEEP_SETTLE) return;
+  SweepAcc += (SweepCh == CORR_DV)? AdcV->FastCode : AdcI->FastCode;
+  if(SweepCnt < SWEEP_SETTLE + SWEEP_AVG) return;
+  uint16_t m = (SweepAcc + SWEEP_AVG / 2) / SWEEP_AVG;
+  //       :
+  if(m > SWEEP_MARGIN && m < ADC_MAX_CODE - SWEEP_MARGIN)
+  {
+    TScaler *a = Scaler(SweepCh + CORR_AV);
+    int32_t c0 = Scaler(SweepCh)->ScaledToCode(a->CodeToScaled(m));
+    uint32_t c = (uint32_t)SweepPt << CORR_SH;
+    if(c > DAC_MAX_CODE) c = DAC_MAX_CODE;
+    int32_t d = (int32_t)c - c0;
+    if(d < -128 || d > 127) { SweepEnd(SWS_FAIL); return; }
+    SweepCorr[SweepPt] = d;
+    SweepMask |= 1UL << SweepPt;
+  }
+  if(++SweepPt == CORR_PTS || !SweepPoint())
+    SweepEnd(SweepMask? SWS_DONE : SWS_FAIL);
+}
+
+//------------------------   : -------------------------
+
+//      ,
+//     EEPROM (  ,
+// SWS_RAM).     
+//.
+
+void TAnalog::SweepEnd(char st)
+{
+  SweepSt = st;
+  if(st == SWS_DONE)
+  {
+    for(char i = 0; i < CORR_PTS; i++)
+    {
+      if(SweepMask & (1UL << i)) continue;
+      char k = 0;
+      while(k < CORR_PTS)
+      {
+        k++;
+        if(i >= k && (SweepMask & (1UL << (i - k))))
+        { SweepCorr[i] = SweepCorr[i - k]; break; }
+        if(i + k < CORR_PTS && (SweepMask & (1UL << (i + k))))
+        { SweepCorr[i] = SweepCorr[i + k]; break; }
+      }
+    }
+    Scaler(SweepCh)->SetCorr(SweepCorr);
+    if(!SaveCorr(SweepCh)) SweepSt = SWS_RAM;
+  }
+  Data->Apply(PAR_SRV);
+  Data->Apply(PAR_SRI);
+  Data->SetVI();
+}
+
+#endif
+
 //----------     MAX_V  MAX_I: -----------
 
 void TAnalog::TrimParamsLimits(void)
@@ -144,9 +666,40 @@ void TAnalog::Execute(void)
   Therm->Execute();
   AdcV->Execute();
   AdcI->Execute();
+#if JRN_ENABLE
+  if(AdcI->FastUpdate) Journal->Sample(AdcV->FastValue, AdcI->FastValue);
+#endif
+  EnergyControl();
+#if CORR_SWEEP
+  SweepControl();
+#endif
+#if AZ_TRACK
+  ZeroTracking();
+#endif
+#if ACAL_ENABLE
+  AcalControl();
+#endif
+#if CAP_ENABLE || JRN_ENABLE
+  char pr = ProtSt;
+#endif
+#if CAP_ENABLE
+  CaptureControl();
+#endif
   CvCcControl();
   ThermalControl();
   Protection();
+#if CAP_ENABLE
+  //    :
+  if(ProtSt & ~pr) Capture->Event(CAP_PROT);
+#endif
+#if JRN_ENABLE
+  //   ( EEPROM  ):
+  if(ProtSt & ~pr)
+    Journal->Event(ProtSt & ~pr, Therm->Value,
+                   Data->MainData->Items[PAR_V]->Value,
+                   Data->MainData->Items[PAR_I]->Value);
+  Journal->Execute();
+#endif
   Supervisor();
   OffTimer();
 }
@@ -195,6 +748,7 @@ void TAnalog::CalibAdcV(char p)
                   CalibData->Items[CAL_VM1]->Value,
                   CalibData->Items[CAL_VP2]->Value,
                   CalibData->Items[CAL_VM2]->Value);
+  ProtDirty = 1;
 }
 
 //--------------------    ADC_I: ------------------------
@@ -211,78 +765,219 @@ void TAnalog::CalibAdcI(char p)
                   CalibData->Items[CAL_IM1]->Value,
                   CalibData->Items[CAL_IP2]->Value,
                   CalibData->Items[CAL_IM2]->Value);
+#if AZ_TRACK
+  //     :
+  AdcI->SetOffset(0);
+  AzZero = AdcI->ScaledToCode(0);
+  AzAcc = 0;
+  AzTime = 0;
+#endif
   int16_t dp = 2 * AdcI->ValueToCode(0) - AdcI->ValueToCode(DP_VAL);
   DP_Code = (dp < 0)? 0 : dp;
+  ProtDirty = 1;
+}
+
+//------------------------   AdcI: -------------------------
+
+#if AZ_TRACK
+
+// ,      
+//      AZ_MAX.
+
+inline void TAnalog::ZeroTracking(void)
+{
+  if(!AdcI->FastUpdate) return;
+  if(Out || Data->SetupData->Items[PAR_DNP]->Value || AzZero <= AZ_MAX)
+  {
+    AzTime = 0;
+    return;
+  }
+  if(AzTime < AZ_DELAY) { AzTime++; return; }
+  int32_t e = (int32_t)AdcI->Code - AzZero;
+  if(e > AZ_MAX) e = AZ_MAX;
+  if(e < -AZ_MAX) e = -AZ_MAX;
+  AzAcc += e - (AzAcc >> AZ_SH);
+  int16_t o = (AzAcc + (1 << (AZ_SH - 1))) >> AZ_SH;
+  if(o != AdcI->GetOffset())
+  {
+    AdcI->SetOffset(o);
+    // Down Programmer    :
+    int16_t dp = 2 * AdcI->ValueToCode(0) - AdcI->ValueToCode(DP_VAL);
+    DP_Code = (dp < 0)? 0 : dp;
+    ProtDirty = 1;
+  }
+}
+
+#endif
+
+//------------------    : ---------------
+
+#if ACAL_ENABLE
+
+//   ,    
+// .
+
+inline void TAnalog::AcalControl(void)
+{
+  if(TSysTimer::SecTick) AcalSec++;
+  if(AcalPer && AcalSec >= AcalPer) AcalReq = 1;
+  int16_t t = Therm->Value;
+  if(Therm->Update && t != TEMP_FAIL)
+  {
+    if(AcalTemp == TEMP_FAIL) AcalTemp = t;
+    int16_t dt = t - AcalTemp;
+    if(AcalDT && (dt >= AcalDT || -dt >= AcalDT)) AcalReq = 1;
+  }
+  if(AcalReq && AdcI->FastUpdate) AdcRecal();
+}
+
+//-------------------------   : ------------------------
+
+void TAnalog::AdcRecal(void)
+{
+  AcalReq = 0;
+  AcalSec = 0;
+  if(Therm->Value != TEMP_FAIL) AcalTemp = Therm->Value;
+  uint32_t t0 = SysTick->VAL;
+  TIM2->CR1 &= ~TIM_CR1_CEN;          //  
+  TSysTimer::Delay_us(ACAL_WAIT);
+  AdcCalibrate();
+  TIM2->CR1 |= TIM_CR1_CEN;
+  int32_t t = t0 - SysTick->VAL;
+  if(t < 0) t += SysTick->LOAD + 1;
+  uint8_t f = ADC1->DR & ADC_CAL_MASK;
+  AcalDelta = f - AcalFactor;
+  AcalFactor = f;
+  AcalTime = t;
+  if(AcalTime > AcalTimeMax) AcalTimeMax = AcalTime;
+  AcalCount++;
+  //     :
+  AdcV->Skip();
+  AdcI->Skip();
+  AcalSkips++;
+}
+
+#endif
+
+//-----------------------   : ---------------------------
+
+// OVP  OCP    ,   FastCode 
+//   ,   FastValue  .
+// OPP floor(V x I / VI2P) >= P  V x I >= P x VI2P.
+//  I2t  OCP  Ilim ,   OCP
+//.
+//    , , ,
+//      ( ProtDirty).
+
+void TAnalog::ProtUpdate(void)
+{
+  ProtDirty = 0;
+  TParam *v = Data->SetupData->Items[PAR_OVP];
+  TParam *i = Data->SetupData->Items[PAR_OCP];
+  TParam *p = Data->SetupData->Items[PAR_OPP];
+  //   Max,  :
+  OvpCode = (v->Value < v->Max)? AdcV->ValueToTrip(v->Value) : PROT_OFF;
+  uint16_t b = Data->SetupData->Items[PAR_I2T]->Value;
+  if(i->Value >= i->Max) b = 0; //  OCP I2t  
+  Fuse->Set(i->Value, b);
+  OcpCode = (i->Value < i->Max && !b)?
+    AdcI->ValueToTrip(i->Value) : PROT_OFF;
+  OppBound = (p->Value < p->Max)? (uint32_t)p->Value * VI2P : PROT_OFF;
+  ProtDel = Data->SetupData->Items[PAR_DEL]->Value;
+#if ADC_IRQ
+  ProtSegs = ProtDel * PROT_BPM;
+  ProtDnp = Data->SetupData->Items[PAR_DNP]->Value;
+#endif
 }
 
 //------------------------  : ------------------------------
 
 inline void TAnalog::Protection(void)
 {
+#if AWD_PROT
+  // analog watchdog:
+  if(AwdTrip)
+  {
+    AwdTrip = 0;
+    OutControl(0);
+    Sound->ABell();
+    ProtSt |= AwdFlag;
+  }
+#endif
+  if(ProtDirty) ProtUpdate();
+#if ADC_IRQ
+  // OVP/OCP    :
+  if(ProtTrip)
+  {
+    char t = ProtTrip;
+    ProtTrip = 0;
+    OutControl(0);
+    Sound->ABell();
+    ProtSt |= t;
+  }
+#else
   //OVP:
-  if(AdcV->FastUpdate)
+  if(AdcV->FastUpdate && OvpCode != PROT_OFF && Out)
   {
-    uint16_t vp = Data->SetupData->Items[PAR_OVP]->Value;
-    // OVP = MAX_V,  :
-    if((vp < Data->SetupData->Items[PAR_OVP]->Max) && Out)
+    if(AdcV->FastCode >= OvpCode)
     {
-      if(Analog->AdcV->FastValue >= vp)
+      if(OvpTimer->Over())
       {
-        if(OvpTimer->Over())
-        {
-          OutControl(0);
-          Sound->ABell();
-          ProtSt |= PR_OVP;
-        }
-      }
-      else
-      {
-        OvpTimer->Start(Data->SetupData->Items[PAR_DEL]->Value);
+        OutControl(0);
+        Sound->ABell();
+        ProtSt |= PR_OVP;
       }
     }
+    else
+    {
+      OvpTimer->Start(ProtDel);
+    }
   }
   //OCP:
-  if(AdcI->FastUpdate)
+  if(AdcI->FastUpdate && OcpCode != PROT_OFF && Out)
   {
-    uint16_t ip = Data->SetupData->Items[PAR_OCP]->Value;
-    // OCP = MAX_I,  :
-    if((ip < Data->SetupData->Items[PAR_OCP]->Max) && Out)
+    if(AdcI->FastCode >= OcpCode)
     {
-      if(Analog->AdcI->FastValue >= ip)
-      {
-        if(OcpTimer->Over())
-        {
-          OutControl(0);
-          Sound->ABell();
-          ProtSt |= PR_OCP;
-        }
-      }
-      else
+      if(OcpTimer->Over())
       {
-        OcpTimer->Start(Data->SetupData->Items[PAR_DEL]->Value);
+        OutControl(0);
+        Sound->ABell();
+        ProtSt |= PR_OCP;
       }
     }
-   //OPP:
-    uint16_t pp = Data->SetupData->Items[PAR_OPP]->Value;
-    // OPP = MAX_P,  :
-    if((pp < Data->SetupData->Items[PAR_OPP]->Max) && Out)
+    else
     {
-      uint16_t pow = (uint32_t)Analog->AdcI->FastValue *
-                               Analog->AdcV->FastValue / VI2P;
-      if(pow >= pp)
-      {
-        if(OppTimer->Over())
-        {
-          OutControl(0);
-          Sound->ABell();
-          ProtSt |= PR_OPP;
-        }
-      }
-      else
+      OcpTimer->Start(ProtDel);
+    }
+  }
+#endif
+  //OPP:
+  if(AdcI->FastUpdate && OppBound != PROT_OFF && Out)
+  {
+    uint32_t pow = (uint32_t)AdcI->FastValue * AdcV->FastValue;
+    if(pow >= OppBound)
+    {
+      if(OppTimer->Over())
       {
-        OppTimer->Start(Data->SetupData->Items[PAR_DEL]->Value);
+        OutControl(0);
+        Sound->ABell();
+        ProtSt |= PR_OPP;
       }
     }
+    else
+    {
+      OppTimer->Start(ProtDel);
+    }
+  }
+  //I2t:
+  if(AdcI->FastUpdate && Fuse->Enabled() && Out)
+  {
+    if(Fuse->Update(AdcI->FastValue))
+    {
+      OutControl(0);
+      Sound->ABell();
+      ProtSt |= PR_I2T;
+    }
   }
 }
 
@@ -376,7 +1071,7 @@ char TAnalog::GetProtSt(void)
 
 void TAnalog::ClrProtSt(void)
 {
-  ProtSt &= ~(PR_OVP | PR_OCP | PR_OPP);
+  ProtSt &= ~(PR_OVP | PR_OCP | PR_OPP | PR_I2T);
 }
 
 //--------------------   CV/CC: ---------------------------
@@ -395,6 +1090,9 @@ inline void TAnalog::CvCcControl(void)
       //  ,  :
       if(prestate != CvCcPre)
       {
+#if CAP_ENABLE
+        Capture->Event(CAP_CVCC);
+#endif
         if(prestate & PS_CV) CVTimer->Start();
         if(prestate & PS_CC) CCTimer->Start();
         CvCcPre = prestate;
@@ -413,6 +1111,67 @@ inline void TAnalog::CvCcControl(void)
   }
 }
 
+//------------------------  : ------------------------------
+
+#if CAP_ENABLE
+
+//  V  I       ,
+//       . DMA 
+//V  I      TIM2,  I 
+//    V,     (1 ).
+//   V  TCapture      .
+
+inline void TAnalog::CaptureControl(void)
+{
+  if(AdcV->FastUpdate)
+  {
+    bool h = AdcV->Half();
+    Capture->Execute(AdcV->Part(h), AdcI->Part(h));
+  }
+}
+
+#endif
+
+//--------------------    : ----------------------
+
+//   (OVER_N / ADC_FS = 1 )   
+//     V x I.  ,
+//   .
+
+inline void TAnalog::EnergyControl(void)
+{
+  if(AdcI->FastUpdate && Out)
+  {
+    uint16_t i = AdcI->FastValue;
+    ChargeAcc += i;
+    EnergyAcc += (uint32_t)AdcV->FastValue * i;
+    EnergyTime++;
+  }
+}
+
+//-------------------     : ----------------------
+
+void TAnalog::EnergyReset(void)
+{
+  ChargeAcc = 0;
+  EnergyAcc = 0;
+  EnergyTime = 0;
+}
+
+//------------------------  , x0.001 : ------------------------
+
+uint32_t TAnalog::GetCharge(void)
+{
+  return(ChargeAcc * 1000 / EN_BLOCKS_H);
+}
+
+//-----------------------  , x0.1 : ------------------------
+
+uint32_t TAnalog::GetEnergy(void)
+{
+  return(EnergyAcc * 10 / (EN_BLOCKS_H * VI2MW));
+}
+
 //------------------------   CV/CC: -----------------------------
 
 char TAnalog::GetCvCcSt(void)
@@ -438,13 +1197,24 @@ bool TAnalog::IsCC(void)
 
 void TAnalog::OutControl(bool on)
 {
+#if SEQ_ENABLE
+  if(!on) Sequencer->Stop();
+#endif
   // :
+  DacV->Hold(1);
   DacV->OnOff(on);
   DacI->OnOff(on);
+  DacV->Hold(0);
   //  Down Programmer,  Pin_ON  :
   if(Data->SetupData->Items[PAR_DNP]->Value)
     Pin_ON = 1;
       else Pin_ON = on;
+  //  ,    I2t   :
+  if(on && !Out)
+  {
+    EnergyReset();
+    Fuse->Reset();
+  }
   Out = on;
   Data->OutOn = on;
   if(!Out)
@@ -457,11 +1227,235 @@ void TAnalog::OutControl(bool on)
   else
   {
     CvCcSt = PS_CV;
+#if !ADC_IRQ
     OvpTimer->Start(Data->SetupData->Items[PAR_DEL]->Value);
     OcpTimer->Start(Data->SetupData->Items[PAR_DEL]->Value);
+#endif
     Display->LedOut = 1;
     TSysTimer::SecReset(); //  
   }
+#if AWD_PROT
+  AwdControl();
+#endif
+}
+
+//---------------------  analog watchdog: --------------------------
+
+#if AWD_PROT
+
+//   12-    .
+//Watchdog        .
+
+void TAnalog::AwdControl(void)
+{
+  ADC1->CR1 &= ~(ADC_CR1_JAWDEN | ADC_CR1_AWDIE |
+                 ADC_CR1_AWDSGL | ADC_CR1_AWDCH);
+  ADC1->SR = ~ADC_SR_AWD;
+  if(!Out || Data->SetupData->Items[PAR_DEL]->Value) return;
+  uint16_t code;
+  char ch;
+  uint16_t ip = Data->SetupData->Items[PAR_OCP]->Value;
+  uint16_t vp = Data->SetupData->Items[PAR_OVP]->Value;
+  if(ip < Data->SetupData->Items[PAR_OCP]->Max &&
+     !Data->SetupData->Items[PAR_I2T]->Value)
+  {
+    code = AdcI->ValueToCode(ip);
+    ch = ADC_PIN_I;
+    AwdFlag = PR_OCP;
+    AwdConv = (uint16_t)(AWD_TCONV * (ADC_CH_I + 1));
+  }
+  else if(vp < Data->SetupData->Items[PAR_OVP]->Max)
+  {
+    code = AdcV->ValueToCode(vp);
+    ch = ADC_PIN_V;
+    AwdFlag = PR_OVP;
+    AwdConv = (uint16_t)(AWD_TCONV * (ADC_CH_V + 1));
+  }
+  else return;
+  AwdDnp = Data->SetupData->Items[PAR_DNP]->Value;
+  //   >=  ( watchdog ):
+  code = (code + (1 << (ADC_RES - ADC_NR)) - 1) >> (ADC_RES - ADC_NR);
+  ADC1->HTR = code? code - 1 : 0;
+  ADC1->LTR = 0;
+  ADC1->CR1 |=
+    ADC_CR1_JAWDEN     * 1 |          //inj. analog watchdog enable
+    ADC_CR1_AWDSGL     * 1 |          //watchdog single scan channel enable
+    ADC_CR1_AWDIE      * 1 |          //analog watchdog interrupt enable
+    ADC_CR1_AWDCH_0    * ch;          //analog watchdog channel
+}
+
+//------------------------  ADC1 (AWD): ----------------------------
+
+void ADC1_IRQHandler(void)
+{
+  if(ADC1->SR & ADC_SR_AWD)
+  {
+    if(!Analog->AwdDnp) Analog->Pin_ON = 0;
+    //     (TIM2 TRGO):
+    uint16_t t = TIM2->CNT;
+    if(t < Analog->AwdConv) t += TIM2->ARR + 1;
+    Analog->DacV->OnOff(0);
+    Analog->DacI->OnOff(0);
+    ADC1->CR1 &= ~(ADC_CR1_JAWDEN | ADC_CR1_AWDIE);
+    ADC1->SR = ~ADC_SR_AWD;
+    Analog->AwdLatency = t;
+    if(t > Analog->AwdLatencyMax) Analog->AwdLatencyMax = t;
+    Analog->AwdTrips++;
+    Analog->AwdTrip = 1;
+  }
+}
+
+#endif
+
+//---------------------   : ----------------------------
+
+#if BENCH_ENABLE
+
+//    op,  CPU. 
+//    (  BENCH_N x 300 ).
+// volatile,       .
+
+uint16_t TAnalog::Bench(char op)
+{
+  static volatile uint32_t Sink;
+  volatile int64_t n = SCALE * (VMAX / 2);
+  volatile int64_t d = SCALE;
+  uint32_t t[2];
+  static union //  BEN_DAC (  )
+  {
+    uint32_t Words[DAC_MAX_FINE * DAC_STEP / 2];
+    uint16_t Table[DAC_MAX_FINE * DAC_STEP];
+  } Dt;
+  __istate_t s = __get_interrupt_state();
+  __disable_interrupt();
+  for(char p = 0; p < 2; p++) //p = 0 -  
+  {
+    uint32_t c = SysTick->VAL;
+    for(uint16_t k = 0; k < BENCH_N; k++)
+    {
+      uint16_t x = k * 2039;
+      uint32_t r = x;
+      if(p) switch(op)
+      {
+      case BEN_LDIV: r = (n + x) / d; break;
+      case BEN_C2V: r = AdcV->CodeToValue(x); break;
+      case BEN_V2C: r = DacV->ValueToCode(x % (VMAX + 1)); break;
+      case BEN_V2D: r = DacV->ValueToDac(x % (VMAX + 1)); break;
+      case BEN_DAC:
+        TDitherDac<0>::Fill(Dt.Table, 1 + x % ((1 << DAC_NR) - 3),
+                            x & (DAC_MAX_FINE - 1));
+        r = Dt.Table[0];
+        break;
+      }
+      Sink = r;
+    }
+    //SysTick  ,      :
+    int32_t e = c - SysTick->VAL;
+    if(e < 0) e += SysTick->LOAD + 1;
+    t[p] = e;
+  }
+  __set_interrupt_state(s);
+  return((t[1] > t[0])? (t[1] - t[0]) / BENCH_N : 0);
+}
+
+#endif
+
+//------------------  DMA  ( ): ------------------
+
+#if ADC_IRQ
+
+//      AdcV ( HTIF7,
+//TCIF7),      .
+
+void DMA1_Channel7_IRQHandler(void)
+{
+  uint32_t f = DMA1->ISR & (DMA_ISR_HTIF7 | DMA_ISR_TCIF7);
+  DMA1->IFCR = f | DMA_IFCR_CGIF7;     //flag clear (IFCR = ISR bits)
+  if(f & DMA_ISR_HTIF7) TOverAdc<ADC_CH_V, ADC_PIN_V>::Done++;
+  if(f & DMA_ISR_TCIF7) TOverAdc<ADC_CH_V, ADC_PIN_V>::Done++;
+#if SCH_ENABLE
+  if(f) TScheduler::Post(SEV_ADC);     //  TAnalog
+#endif
+}
+
+//      AdcV (PROT_TIM Update
+// PROT_SEG  TIM2 TRGO).   
+//    DMA  V,  ,
+// -  ,     .
+//   AdcI     :  DMA  I
+//(CC1)     V (CC2)    TIM2.
+//      (CC2  
+// TIM2)   .
+
+void TIM4_IRQHandler(void)
+{
+  uint16_t e = TIM2->CNT;              //    - 1
+  uint32_t s = SysTick->VAL;
+  PROT_TIM->SR = ~TIM_SR_UIF;
+  TAnalog *a = Analog;
+  if(!a) return;
+  uint8_t p = (ADC_BUFF - DMA1_Channel7->CNDTR) / PROT_SEG;
+  char t = PR_OK;
+  while(a->ProtSeg != p)
+  {
+    uint8_t n = a->ProtSeg;
+    if(a->AdcV->Over(n, a->Out? a->OvpCode : PROT_OFF, a->ProtSegs))
+      t |= PR_OVP;
+    if(a->AdcI->Over(n, a->Out? a->OcpCode : PROT_OFF, a->ProtSegs))
+      t |= PR_OCP;
+    if(++n == ADC_BUFF / PROT_SEG) n = 0;
+    a->ProtSeg = n;
+  }
+  if(t == PR_OK) return;
+  if(!a->ProtDnp) a->Pin_ON = 0;
+  a->DacV->OnOff(0);
+  a->DacI->OnOff(0);
+  if(!a->ProtTrip)
+  {
+    int32_t c = s - SysTick->VAL;
+    if(c < 0) c += SysTick->LOAD + 1;
+    c += e + 1;
+    a->ProtLatency = c;
+    if(c > a->ProtLatencyMax) a->ProtLatencyMax = c;
+    a->ProtTrips++;
+  }
+  a->ProtTrip |= t;
+}
+
+#endif
+
+//-----------------  DMA  ( ): ----------------
+
+void DMA1_Channel2_IRQHandler(void)
+{
+  TDitherDac<0>::Swap();
+}
+
+void DMA1_Channel3_IRQHandler(void)
+{
+  TDitherDac<1>::Swap();
+}
+
+//-------------------------   : ------------------------
+
+// V  I      ( DAC_DUAL).
+//     ,   
+//  .     
+//   .
+
+void TIM7_IRQHandler(void)
+{
+  RAMP_TIM->SR = ~TIM_SR_UIF;
+  Analog->DacV->Hold(1);
+#if SEQ_ENABLE
+  bool s = Analog->Sequencer->Tick();
+#else
+  bool s = 0;
+#endif
+  bool v = Analog->DacV->Slew();
+  bool i = Analog->DacI->Slew();
+  Analog->DacV->Hold(0);
+  if(!v && !i && !s) RAMP_TIM->CR1 &= ~TIM_CR1_CEN;
 }
 
 //----------------------   : ----------------------------
@@ -15,6 +15,9 @@
 #include "data.h"
 #include "ditherdac.h"
 #include "overadc.h"
+#include "capture.h"
+#include "sequencer.h"
+#include "journal.h"
 
 //------------------------------- : ---------------------------------
 
@@ -187,8 +190,18 @@ enum CalibData_t
 // :
 
 #define ADC_TUPD 320 //   , 
+#define ADC_TAVF  40 //   ( METER_AVF), 
 #define CVCC_DEL 120 //   CV/CC, 
 #define FIR_POINTS (ADC_TUPD * ADC_FS / OVER_N / 1000)
+#define FIR_POINTS_F (ADC_TAVF * ADC_FS / OVER_N / 1000)
+#define RPL_POINTS FIR_POINTS //  , 
+#define FIR_DEC 8 //     
+#define FIR_GRPS (FIR_POINTS / FIR_DEC)     //  ( ADC_TUPD)
+#define FIR_GRPS_F (FIR_POINTS_F / FIR_DEC) //  ADC_TAVF
+
+#if (FIR_POINTS % FIR_DEC) || (FIR_POINTS_F % FIR_DEC) || (FIR_GRPS > 255)
+  #error "FIR_DEC must divide FIR_POINTS and FIR_POINTS_F"
+#endif
 #define ADC_PIN_V PIN7
 #define ADC_PIN_I PIN6
 #define ADC_CH_V 1
@@ -196,9 +209,97 @@ enum CalibData_t
 #define DAC_CH_V 1
 #define DAC_CH_I 0
 
+//  OVP/OCP   analog watchdog ADC1.
+//     PAR_DEL.   watchdog ,
+//   : ,   OCP, 
+//,   OVP.    
+// ,    .  12- 
+//    ,    
+//,   (ADC_IRQ)     1 .
+
+#define AWD_PROT 0 //   analog watchdog on/off
+
+//  OVP/OCP     
+//(ADC_IRQ).  PROT_TIM    (TIM2 TRGO)
+//        PROT_SEG 
+//(1  / PROT_BPM = 0.1 ).     
+//  PROT_BPM  (1 ,   ), 
+//  .  PAR_DEL  
+// ,     ,   
+//  ,    .   
+//   .     
+// ,     1   , ..  
+// ,     ,    0.1   1 .
+//  1        
+//.       .
+
+//  ( - ): analog watchdog 0, 
+//  DAC_IRQ_PRI (     , 
+//DMA      ),    
+//PROT_IRQ_PRI,  RAMP_IRQ_PRI,  15.   
+//      .
+
+#define ADC_BPM (ADC_FS / OVER_N / 1000) //   1 
+#define PROT_BPM     10 //    1 
+#define PROT_SEG (ADC_FS / 1000 / PROT_BPM) //  
+#define PROT_WIN (PROT_SEG * PROT_BPM) //    (1 )
+#define PROT_TIM   TIM4 //  (   TIM2 TRGO)
+#define PROT_IRQN  TIM4_IRQn //  
+#define PROT_IRQ_PRI  2 //     
+
+#if (OVER_N % PROT_SEG) || !PROT_SEG || (ADC_BUFF / PROT_SEG > 255)
+  #error "OVER_N must be a multiple of PROT_SEG"
+#endif
+
+//  I2t:   PAR_I2T  OCP
+//  (I^2 - Ilim^2)dt    ,
+//Ilim = PAR_OCP.     (),   
+//.  ,     PAR_I2T,
+//   I > Ilim  t = B / (I^2 - Ilim^2),  
+// .     .
+
+#define I2T_UNIT (10000000ULL * ADC_BPM) //0.01 A^2  ^2 x  
+
+//  AdcI:    (  Down
+//Programmer)    ,  AZ_DELAY  
+//  AdcI       
+// 2^AZ_SH        AdcI.
+//  AZ_MAX     .
+
+#define AZ_TRACK 1 //  AdcI on/off
+#define AZ_DELAY 1000 //    , 
+#define AZ_SH 14 //  , 2^AZ_SH  (16 )
+#define AZ_MAX (8 << (ADC_RES - ADC_NR)) // , 8 LSB ADC_NR
+
+//  :   ACAL_PER   
+//   ACAL_DT    .
+//    : TIM2 , 
+//    (ACAL_WAIT) 
+//,  TIM2  . DMA    ,
+//     .
+
+#define ACAL_ENABLE 1 //   on/off
+#define ACAL_PER  600 //   ,  (0 - )
+#define ACAL_DT    50 //   , x0.1C
+#define ACAL_WAIT  10 //   , 
+
+//         
+//    64-  ,   .
+
+#define EN_BLOCKS_H ((uint64_t)ADC_FS * 3600 / OVER_N) //   
+#define VI2MW ((uint32_t)(0.001 / (V_RES * I_RES) + 0.5)) //VI  
+
 //  :
 
-enum MeterMode_t { METER_AVG, METER_PKH, METER_PKL };
+enum MeterMode_t { METER_AVG, METER_PKH, METER_PKL, METER_AVF, METER_RPL,
+                   METER_ADP };
+
+//  ( METER_ADP):  FastCode  ADP_THR
+// Code  ADP_CONF      ADP_CONF
+//,           METER_AVG.
+
+#define ADP_THR  (4 << (ADC_RES - ADC_NR)) // , 4 LSB ADC_NR
+#define ADP_CONF 2 //   
 
 #define HOLD_TIME      1000 //   , 
 #define PVG_PER          50 //   PVG, 
@@ -222,50 +323,238 @@ enum PrState_t
   PR_OVP   = 1,
   PR_OCP   = 2,
   PR_OPP   = 4,
-  PR_OTP   = 8
+  PR_OTP   = 8,
+  PR_I2T   = 16
+};
+
+//    (CMD_GET_BENCH): 
+// BENCH_N      
+//,    SysTick,   
+//.     .
+//          
+//   DAC_BANK 1  0.
+
+#define BENCH_ENABLE 0 //   on/off
+#define BENCH_N     32 //  
+
+// :
+
+enum BenchOp_t
+{
+  BEN_LDIV, //64-  (__aeabi_ldivmod)   
+  BEN_C2V,  //TScaler::CodeToValue
+  BEN_V2C,  //TScaler::ValueToCode
+  BEN_V2D,  //TScaler::ValueToDac
+  BEN_DAC,  //    (TDitherDac::Fill)
+  BEN_OPS
+};
+
+//--------------------------  : ------------------------------
+
+uint32_t ISqrt(uint64_t x); //  
+
+//----------------------------------------------------------------------------
+//-----------------------------  TRecip: --------------------------------
+//----------------------------------------------------------------------------
+
+// 64-     D  
+//    R = 2^S / D (32 ).
+//      ,  
+// ,      n / D.
+//    Q  (n < 2^Q * D).
+
+class TRecip
+{
+private:
+  uint64_t D;
+  uint32_t R;
+  uint8_t A;
+  uint8_t S;
+public:
+  void Init(uint64_t d, uint8_t q);
+  uint32_t Div(uint64_t n);
 };
 
+//----------------------------- : -------------------------------------
+
+inline uint32_t TRecip::Div(uint64_t n)
+{
+  uint32_t q = ((uint64_t)(uint32_t)(n >> A) * R) >> (S - A);
+  uint64_t r = n - (uint64_t)q * D;
+  while(r >= D)
+  {
+    q++;
+    r -= D;
+  }
+  return(q);
+}
+
+//----------------------------------------------------------------------------
+//------------------------------  TFuse: --------------------------------
+//----------------------------------------------------------------------------
+
+// I2t,          .
+
+class TFuse
+{
+private:
+  uint32_t Lim2;  // , ^2
+  uint64_t Bound; //, ^2 x  (0 - )
+public:
+  TFuse(void);
+  uint64_t Acc;   // (I^2 - Ilim^2)dt, ^2 x 
+  void Set(uint16_t lim, uint16_t b);
+  bool Enabled(void) { return(Bound); }
+  void Reset(void) { Acc = 0; }
+  bool Update(uint16_t i);
+};
+
+//--------------------------  : ------------------------------------
+
+// true,   .
+
+inline bool TFuse::Update(uint16_t i)
+{
+  uint32_t i2 = (uint32_t)i * i;
+  if(i2 >= Lim2) Acc += i2 - Lim2;
+    else Acc = (Acc > Lim2 - i2)? Acc - (Lim2 - i2) : 0;
+  return(Bound && Acc >= Bound);
+}
+
 //----------------------------------------------------------------------------
 //-----------------------------  TScaler: -------------------------------
 //----------------------------------------------------------------------------
 
+#define PROT_OFF 0xFFFFFFFFUL // ,   
+
+//  : CORR_PTS    
+// ( 1 << CORR_SH),      int8_t.
+//    .   
+//      ,   -  ,
+//  .    (ValueToCode 
+//  DP_Code)  ,  : 
+//   1/16,     
+//   .    .
+
+#define CORR_PTS 17 //   
+#define CORR_SH  12 //     
+
+//     EEPROM ,     :
+//CORR_WORDS + 2 = 36  ( TCrcSection, . data.h).
+
+#define CORR_EEPROM 1 //    EEPROM on/off
+
+//   :    
+//  ,    ,  
+//     ,   
+//   .    MAXV/MAXI 
+//,    ,    .
+
+#define CORR_SWEEP     1 //    on/off
+#define SWEEP_SETTLE 300 //   , 
+#define SWEEP_AVG    256 //   
+#define SWEEP_MARGIN 256 //   
+
+//  :
+
+enum SweepState_t
+{
+  SWS_IDLE, // 
+  SWS_RUN,  //
+  SWS_DONE, //     EEPROM
+  SWS_FAIL, //
+  SWS_RAM   // ,     RAM (  EEPROM)
+};
+
+// :
+
+enum CorrCh_t { CORR_DV, CORR_DI, CORR_AV, CORR_AI, CORR_CH };
+
+#define CORR_WORDS ((CORR_PTS * CORR_CH + 1) / 2) //   EEPROM
+
 class TScaler
 {
 private:
   int64_t Kx;
   int64_t Sx;
+  int64_t NmV;  //  CodeToValue
+  int64_t NmC;  //  ValueToCode
+  TRecip RecS;  //  SCALE
+  TRecip RecK;  //  Kx
+  int8_t Corr[CORR_PTS];
+  bool CorrOn;
+  bool CorrIn;     //  ()
+  int16_t Offset;  //  
+  int16_t Delta(uint16_t code);
+  uint16_t Correct(uint16_t code, uint16_t max);
+  uint16_t Uncorrect(uint16_t code);
+  uint16_t Shift(uint16_t code, int16_t d, uint16_t max);
 public:
-  TScaler(void) {};
+  TScaler(bool adc = 0);
+  void SetCorr(const int8_t *p);
+  int8_t GetCorr(char n);
   void Calibrate(uint16_t p1, uint16_t c1,
                  uint16_t p2, uint16_t c2);
   uint16_t CodeToValue(uint16_t code);
   uint16_t ValueToCode(uint16_t value);
+  uint32_t ValueToTrip(uint16_t value);
+  uint32_t ValueToDac(uint16_t value);
+  uint16_t SpanToValue(uint16_t span);
+  int64_t CodeToScaled(uint16_t code);
+  int32_t ScaledToCode(int64_t n);
+  void SetOffset(int16_t o);
+  int16_t GetOffset(void);
 };
 
 //----------------------------------------------------------------------------
 //-------------------------   TDac: ----------------------------
 //----------------------------------------------------------------------------
 
+//  (soft-start):     
+//      Rate (   1 ).
+//    RAMP_TIM   RAMP_FS, 
+//   .     
+// . Rate = 0 -  .
+// RAMP_TIM     (TSequencer).
+
+#define RAMP_TIM   TIM7 // 
+#define RAMP_IRQN  TIM7_IRQn //  
+#define RAMP_FS    5000 //  , 
+#define RAMP_SH       8 //   
+#define RAMP_IRQ_PRI  3 //  
+
 template<uint8_t DacN>
 class TDac : public TScaler
 {
 private:
   TDitherDac<DacN> Dac;
-  uint16_t Code;
-  uint16_t ZeroCode;
-  bool On;
+  uint32_t Code;
+  uint32_t ZeroCode;
+  volatile bool On;
+  uint16_t Rate;          // ,    1 
+  volatile uint32_t Cur;  //,   
+  uint32_t Target;        //  
+  uint32_t Pos;           //  , 1 / 2^RAMP_SH 
+  uint32_t Step;          // , 1 / 2^RAMP_SH 
+  volatile bool Ramp;     // 
+  void Load(uint32_t c);
+  void Cut(void);
 public:
   TDac(void);
   void SetCode(uint16_t c);
   void SetZero(uint16_t z);
   void SetValue(uint16_t v);
   void OnOff(bool on);
+  void SetRate(uint16_t r);
+  bool Slew(void);
+  static void Hold(bool on) { TDitherDac<DacN>::Hold(on); }
 };
 
 //-------------------------  : ------------------------------
 
 template<uint8_t DacN>
-TDac<DacN>::TDac(void) : On(0), Code(0)
+TDac<DacN>::TDac(void) : Code(0), ZeroCode(0), On(0), Rate(0), Cur(0),
+  Target(0), Pos(0), Step(0), Ramp(0)
 {
   Dac.Init();
 }
@@ -273,75 +562,235 @@ TDac<DacN>::TDac(void) : On(0), Code(0)
 template<uint8_t DacN>
 void TDac<DacN>::SetCode(uint16_t c)
 {
-  Code = c;
-  if(On) Dac = Code;
+  Code = (uint32_t)c << DAC_EXT;
+  if(On) Load(Code);
 }
 
 template<uint8_t DacN>
 void TDac<DacN>::SetZero(uint16_t z)
 {
-  ZeroCode = ValueToCode(z);
-  if(!On) Dac = ZeroCode;
+  ZeroCode = ValueToDac(z);
+  NVIC_DisableIRQ(RAMP_IRQN);
+  if(!On) Cut();
+  NVIC_EnableIRQ(RAMP_IRQN);
 }
 
 template<uint8_t DacN>
 void TDac<DacN>::SetValue(uint16_t v)
 {
-  Code = ValueToCode(v);
-  if(On) Dac = Code;
+  Code = ValueToDac(v);
+  if(On) Load(Code);
 }
 
 template<uint8_t DacN>
 void TDac<DacN>::OnOff(bool on)
 {
-  On = on;
-  Dac = On? Code : ZeroCode;
+  if(on)
+  {
+    On = 1;
+    Load(Code);
+  }
+  else
+  {
+    //    :
+    On = 0;
+    Cut();
+  }
+}
+
+//  .     
+//          RAMP_TIM,
+//   On     
+// .
+
+template<uint8_t DacN>
+void TDac<DacN>::Cut(void)
+{
+  Ramp = 0;
+  Cur = ZeroCode;
+  Dac = ZeroCode;
+}
+
+template<uint8_t DacN>
+void TDac<DacN>::SetRate(uint16_t r)
+{
+  Rate = r;
+}
+
+//     (   ).
+// , ,   ,
+//    .    
+//RAMP_TIM ,      .
+
+template<uint8_t DacN>
+void TDac<DacN>::Load(uint32_t c)
+{
+  NVIC_DisableIRQ(RAMP_IRQN); //    
+  Ramp = 0;
+  if(!Rate || c <= Cur)
+  {
+    Cur = c;
+    Dac = c;
+  }
+  else
+  {
+    uint32_t Span = ValueToDac(Rate) - ValueToDac(0); //  1 
+    Step = (Span << RAMP_SH) / (RAMP_FS / 1000);
+    if(!Step) Step = 1;
+    Target = c;
+    Pos = Cur << RAMP_SH;
+    Ramp = 1;
+    RAMP_TIM->CR1 |= TIM_CR1_CEN;
+  }
+  //       :
+  if(!On) Cut();
+  NVIC_EnableIRQ(RAMP_IRQN);
+}
+
+//  ( RAMP_TIM),  true,   .
+
+template<uint8_t DacN>
+bool TDac<DacN>::Slew(void)
+{
+  if(!Ramp) return(0);
+  Pos += Step;
+  if(Pos >= (Target << RAMP_SH))
+  {
+    Cur = Target;
+    Ramp = 0;
+  }
+  else
+  {
+    Cur = Pos >> RAMP_SH;
+  }
+  Dac = Cur;
+  //       :
+  if(!On) Cut();
+  return(Ramp);
 }
 
 //----------------------------------------------------------------------------
 //-------------------------   TAdc: ----------------------------
 //----------------------------------------------------------------------------
 
+//   :  FastCode 
+//  FIR_DEC ,    
+//   FirBuff[].    FirGrps 
+//  (  FirCode    )
+//   FirPart,      
+//FIR_DEC : FIR_POINTS..FIR_POINTS + FIR_DEC - 1  (ADC_TUPD),
+//  METER_AVF - FIR_POINTS_F..FIR_POINTS_F + FIR_DEC - 1 
+//(ADC_TAVF). Code  Value   1 .   METER_ADP
+//     ADP_CONF    
+// (FirWindow),     : 
+//  ADP_CONF ,    1 / sqrt()
+//  METER_AVG.
+// RAM: FIR_GRPS * 4 = 160   .
+//:   RPL_POINTS     
+// ,      
+//RplRms,    -  RplPp.  
+//  ,   METER_RPL    RplRms.
+
 template<uint8_t AdcN, uint8_t AdcPin>
 class TAdc : public TScaler
 {
 private:
   TOverAdc<AdcN, AdcPin> Adc;
-  uint32_t FirCode;
-  uint16_t FirPointer;
+  uint32_t FirBuff[FIR_GRPS]; //  
+  uint32_t FirCode;  //     
+  uint32_t FirPart;  //  
+  uint32_t AdpSum;   //   
+  uint16_t FirWindow; //  ,  (0 -  )
+  uint16_t FirCount;
+  uint8_t FirPos;    //   
+  uint8_t FirPhase;  //   
+  uint8_t FirGrps;   //   
   bool ReadyFlag;
   uint16_t HoldTime;
   char Mode;
+  int8_t AdpCnt;
+  bool SkipFlag;
+#if ADC_IRQ
+  uint16_t SegSum[PROT_BPM]; //   
+  uint32_t WinSum;  //   (PROT_BPM )
+  uint8_t SegPos;   //     SegSum
+  uint16_t OverCnt; //     
+#endif
+  void Adapt(void);
+  void Resum(void);
+  uint64_t RplSum2;
+  uint32_t RplSum;
+  uint16_t RplMin;
+  uint16_t RplMax;
+  uint16_t RplCount;
+  void Ripple(void);
 public:
   TAdc(void);
   void Execute(void);
   void SetMode(char m);
+  void Skip(void);
   bool FastUpdate;
   uint16_t FastCode;
   uint16_t FastValue;
+  uint16_t FastMin;
+  uint16_t FastMax;
   bool Query(void);
   bool Ready(void);
   void Sync(void);
+  uint32_t Overrun(void);
+  bool Half(void);
+  const uint16_t *Part(bool h);
+#if ADC_IRQ
+  bool Over(uint8_t seg, uint32_t thr, uint16_t n);
+#endif
   uint16_t Code;
   uint16_t Value;
+  uint16_t RplRms;
+  uint16_t RplPp;
 };
 
 //-------------------------  : ------------------------------
 
 template<uint8_t AdcN, uint8_t AdcPin>
-TAdc<AdcN, AdcPin>::TAdc(void)
+TAdc<AdcN, AdcPin>::TAdc(void) : TScaler(1)
 {
   Adc.Init();
   Mode = METER_AVG;
   HoldTime = 0;
+  AdpCnt = 0;
+  SkipFlag = 0;
+#if ADC_IRQ
+  for(uint8_t i = 0; i < PROT_BPM; i++)
+    SegSum[i] = 0;
+  WinSum = 0;
+  SegPos = 0;
+  OverCnt = 0;
+#endif
   FastUpdate = 0;
+  for(uint8_t i = 0; i < FIR_GRPS; i++)
+    FirBuff[i] = 0;
   FirCode = 0;
-  FirPointer = 0;
+  FirPart = 0;
+  AdpSum = 0;
+  FirWindow = 0;
+  FirCount = 0;
+  FirPos = 0;
+  FirPhase = 0;
+  FirGrps = FIR_GRPS;
   FastCode = 0;
   FastValue = 0;
+  FastMin = 0;
+  FastMax = 0;
   ReadyFlag = 0;
   Code = 0;
   Value = 0;
+  RplSum2 = 0;
+  RplSum = 0;
+  RplMin = ADC_MAX_CODE;
+  RplMax = 0;
+  RplCount = 0;
+  RplRms = 0;
+  RplPp = 0;
 }
 
 template<uint8_t AdcN, uint8_t AdcPin>
@@ -349,51 +798,112 @@ void TAdc<AdcN, AdcPin>::SetMode(char m)
 {
   Mode = m;
   HoldTime = 0;
+  AdpCnt = 0;
+  //    :
+  FirGrps = (Mode == METER_AVF)? FIR_GRPS_F : FIR_GRPS;
+  FirWindow = 0;
+  Resum();
+}
+
+// FirGrps   .
+
+template<uint8_t AdcN, uint8_t AdcPin>
+void TAdc<AdcN, AdcPin>::Resum(void)
+{
+  FirCode = 0;
+  uint8_t p = FirPos;
+  for(uint8_t i = 0; i < FirGrps; i++)
+  {
+    if(!p) p = FIR_GRPS;
+    FirCode += FirBuff[--p];
+  }
 }
 
 template<uint8_t AdcN, uint8_t AdcPin>
 void TAdc<AdcN, AdcPin>::Execute(void)
 {
-  if(Adc.Ready())
+  if(Adc.Ready() && SkipFlag)
+  {
+    //     :
+    SkipFlag = 0;
+    (void)(uint16_t)Adc;
+    FastUpdate = 0;
+  }
+  else if(Adc.Ready())
   {
     FastCode = Adc;
+    FastMin = Adc.Min;
+    FastMax = Adc.Max;
     FastValue = CodeToValue(FastCode);
     if(HoldTime) HoldTime--;
-    FirCode += FastCode;
-    if(++FirPointer == FIR_POINTS)
+    FirPart += FastCode;
+    //     :
+    if(FirWindow)
     {
-      Code = (FirCode + FIR_POINTS / 2) / FIR_POINTS;
-      if(Mode == METER_AVG)
-      {
-        Value = CodeToValue(Code);
-      }
-      FirCode = FirPointer = 0;
+      FirCode += FastCode;
+      FirWindow++;
+    }
+    //   :     
+    // ,    ,   :
+    if(++FirPhase == FIR_DEC)
+    {
+      uint8_t p = FirPos + FIR_GRPS - FirGrps;
+      if(p >= FIR_GRPS) p -= FIR_GRPS;
+      if(!FirWindow) FirCode += FirPart - FirBuff[p];
+      FirBuff[FirPos] = FirPart;
+      if(++FirPos == FIR_GRPS) FirPos = 0;
+      FirPart = 0;
+      FirPhase = 0;
+    }
+    if(Mode == METER_ADP) Adapt();
+    uint16_t n = FirGrps * FIR_DEC + FirPhase;
+    //    :
+    if(FirWindow >= n)
+    {
+      FirWindow = 0;
+      Resum();
+    }
+    if(FirWindow)
+      Code = (FirCode + FirWindow / 2) / FirWindow;
+        else Code = (FirCode + FirPart + n / 2) / n;
+    if(Mode == METER_AVG || Mode == METER_AVF || Mode == METER_ADP)
+    {
+      Value = CodeToValue(Code);
+    }
+    Ripple();
+    //     ADC_TUPD:
+    if(++FirCount == FIR_POINTS)
+    {
+      FirCount = 0;
       ReadyFlag = 1;
     }
+    //     :
     if(Mode == METER_PKH)
     {
-      if(FastValue >= Value)
+      uint16_t pk = CodeToValue(FastMax);
+      if(pk >= Value)
       {
-        Value = FastValue;
+        Value = pk;
         HoldTime = HOLD_TIME;
       }
       else
       {
         if(!HoldTime)
-          Value = FastValue;
+          Value = pk;
       }
     }
     if(Mode == METER_PKL)
     {
-      if(FastValue <= Value)
+      uint16_t pk = CodeToValue(FastMin);
+      if(pk <= Value)
       {
-        Value = FastValue;
+        Value = pk;
         HoldTime = HOLD_TIME;
       }
       else
       {
         if(!HoldTime)
-          Value = FastValue;
+          Value = pk;
       }
     }
     FastUpdate = 1;
@@ -404,6 +914,66 @@ void TAdc<AdcN, AdcPin>::Execute(void)
   }
 }
 
+//    ( ).
+
+template<uint8_t AdcN, uint8_t AdcPin>
+inline void TAdc<AdcN, AdcPin>::Skip(void)
+{
+  SkipFlag = 1;
+}
+
+//    . Code   
+// .   ADP_CONF   ,
+//     (    AdpSum).
+
+template<uint8_t AdcN, uint8_t AdcPin>
+void TAdc<AdcN, AdcPin>::Adapt(void)
+{
+  int32_t d = (int32_t)FastCode - Code;
+  if(d > ADP_THR)
+  {
+    if(AdpCnt <= 0) { AdpCnt = 0; AdpSum = 0; }
+    AdpCnt++;
+  }
+  else if(d < -ADP_THR)
+  {
+    if(AdpCnt >= 0) { AdpCnt = 0; AdpSum = 0; }
+    AdpCnt--;
+  }
+  else AdpCnt = 0;
+  AdpSum += FastCode;
+  if(AdpCnt >= ADP_CONF || AdpCnt <= -ADP_CONF)
+  {
+    AdpCnt = 0;
+    FirWindow = ADP_CONF;
+    FirCode = AdpSum;
+  }
+}
+
+template<uint8_t AdcN, uint8_t AdcPin>
+void TAdc<AdcN, AdcPin>::Ripple(void)
+{
+  RplSum += Adc.Sum;
+  RplSum2 += Adc.Sum2;
+  if(FastMin < RplMin) RplMin = FastMin;
+  if(FastMax > RplMax) RplMax = FastMax;
+  if(++RplCount == RPL_POINTS)
+  {
+    //n^2 * D = n * S2 - S1^2,  = sqrt(n^2 * D) / n:
+    const uint32_t n = (uint32_t)RPL_POINTS * OVER_N;
+    uint64_t d = RplSum2 * n - (uint64_t)RplSum * RplSum;
+    uint32_t r = ISqrt(d) * (1 << (ADC_RES - ADC_NR));
+    RplRms = SpanToValue((r + n / 2) / n);
+    RplPp = SpanToValue(RplMax - RplMin);
+    if(Mode == METER_RPL) Value = RplRms;
+    RplSum2 = 0;
+    RplSum = 0;
+    RplMin = ADC_MAX_CODE;
+    RplMax = 0;
+    RplCount = 0;
+  }
+}
+
 template<uint8_t AdcN, uint8_t AdcPin>
 inline bool TAdc<AdcN, AdcPin>::Query(void)
 {
@@ -424,17 +994,96 @@ inline bool TAdc<AdcN, AdcPin>::Ready(void)
 template<uint8_t AdcN, uint8_t AdcPin>
 void TAdc<AdcN, AdcPin>::Sync(void)
 {
-  FirCode = FirPointer = 0;
+  FirCount = 0;
   ReadyFlag = 0;
 }
 
+template<uint8_t AdcN, uint8_t AdcPin>
+inline uint32_t TAdc<AdcN, AdcPin>::Overrun(void)
+{
+  return(Adc.Overrun);
+}
+
+//  ,     .
+
+template<uint8_t AdcN, uint8_t AdcPin>
+inline bool TAdc<AdcN, AdcPin>::Half(void)
+{
+  return(Adc.Block != Adc.Part(0));
+}
+
+//   h ( ADC_NR).
+
+template<uint8_t AdcN, uint8_t AdcPin>
+inline const uint16_t *TAdc<AdcN, AdcPin>::Part(bool h)
+{
+  return(Adc.Part(h));
+}
+
+//------------------    : ------------------------
+
+#if ADC_IRQ
+
+//   , seg -   
+// .       , 
+//  ( ADC_RES)     :
+//(WinSum * 2^(ADC_RES - ADC_NR) + PROT_WIN / 2) / PROT_WIN >= thr.
+// true,      n  .
+// thr = PROT_OFF    .
+
+template<uint8_t AdcN, uint8_t AdcPin>
+bool TAdc<AdcN, AdcPin>::Over(uint8_t seg, uint32_t thr, uint16_t n)
+{
+  if(thr == PROT_OFF)
+  {
+    if(WinSum)
+      for(uint8_t i = 0; i < PROT_BPM; i++)
+        SegSum[i] = 0;
+    WinSum = 0;
+    OverCnt = 0;
+    return(0);
+  }
+  const uint16_t *s = Adc.Part(0) + seg * PROT_SEG;
+  uint16_t sum = 0;
+  for(uint8_t k = 0; k < PROT_SEG; k++)
+    sum += s[k];
+  WinSum = WinSum - SegSum[SegPos] + sum;
+  SegSum[SegPos] = sum;
+  if(++SegPos == PROT_BPM) SegPos = 0;
+  uint32_t w = WinSum * (1 << (ADC_RES - ADC_NR)) + PROT_WIN / 2;
+  if(w < thr * PROT_WIN) OverCnt = 0;
+    else if(OverCnt < 0xFFFF) OverCnt++;
+  return(OverCnt > n);
+}
+
+#endif
+
 //----------------------------------------------------------------------------
 //-----------------------------  TAnalog: -------------------------------
 //----------------------------------------------------------------------------
 
+extern "C" void ADC1_IRQHandler(void);
+extern "C" void TIM7_IRQHandler(void);
+extern "C" void DMA1_Channel7_IRQHandler(void);
+extern "C" void TIM4_IRQHandler(void);
+
 class TAnalog
 {
 private:
+#if AWD_PROT
+  friend void ADC1_IRQHandler(void);
+  volatile bool AwdTrip;
+  bool AwdDnp;
+  char AwdFlag;
+  uint16_t AwdConv;
+#endif
+#if ADC_IRQ
+  friend void TIM4_IRQHandler(void);
+  volatile char ProtTrip; //   
+  bool ProtDnp;
+  uint8_t ProtSeg;        //   
+  uint16_t ProtSegs;      // , 
+#endif
   TGpio<PORTB, PIN0> Pin_CC;
   TGpio<PORTB, PIN1> Pin_ON;
   TGpio<PORTA, PIN12> Pin_PVG;
@@ -445,17 +1094,53 @@ private:
   char ProtSt;
   char CvCcSt;
   char CvCcPre;
+  uint32_t OvpCode;   // OVP,  AdcV (PROT_OFF - )
+  uint32_t OcpCode;   // OCP,  AdcI (PROT_OFF - )
+  uint32_t OppBound;  // OPP, V x I (PROT_OFF - )
+  uint16_t ProtDel;   // , 
+  bool ProtDirty;     //  
+  void ProtUpdate(void);
   void Protection(void);
   void Supervisor(void);
   void CvCcControl(void);
   void ThermalControl(void);
   void OffTimer(void);
+  void EnergyControl(void);
+#if CAP_ENABLE
+  void CaptureControl(void);
+#endif
+#if ACAL_ENABLE
+  uint32_t AcalSec;  //   
+  int16_t AcalTemp;  //  
+  bool AcalReq;
+  void AcalControl(void);
+  void AdcRecal(void);
+#endif
+#if AZ_TRACK
+  int32_t AzZero;  //    
+  int32_t AzAcc;   //, 1 / 2^AZ_SH 
+  uint16_t AzTime;
+  void ZeroTracking(void);
+#endif
+#if CORR_SWEEP
+  char SweepCh;
+  uint16_t SweepCnt;
+  uint32_t SweepAcc;
+  uint32_t SweepMask;
+  int8_t SweepCorr[CORR_PTS];
+  void SweepControl(void);
+  bool SweepPoint(void);
+  void SweepEnd(char st);
+#endif
   TSoftTimer *CCTimer;
   TSoftTimer *CVTimer;
+#if !ADC_IRQ
   TSoftTimer *OvpTimer;
   TSoftTimer *OcpTimer;
+#endif
   TSoftTimer *OppTimer;
   TSoftTimer *OutBlinkTimer;
+  TFuse *Fuse;
 public:
   TAnalog(void);
   TParamList *CalibData;
@@ -463,6 +1148,18 @@ public:
   TAdc<ADC_CH_I, ADC_PIN_I> *AdcI;
   TDac<DAC_CH_V> *DacV;
   TDac<DAC_CH_I> *DacI;
+#if CORR_EEPROM
+  TCrcSection *CorrData;
+#endif
+  TScaler *Scaler(char ch);
+  void InitCorr(void);
+  bool SaveCorr(char ch);
+#if CORR_SWEEP
+  char SweepSt;
+  char SweepPt;
+  bool SweepStart(char ch);
+  void SweepStop(void);
+#endif
   void TrimParamsLimits(void);
   void Execute(void);
   void CalibAll(void);
@@ -474,6 +1171,7 @@ public:
   uint16_t OffTime;
   void OutControl(bool on);
   bool OutState(void);
+  void ProtChanged(void) { ProtDirty = 1; }
   char GetProtSt(void);
   void ClrProtSt(void);
   char GetCvCcSt(void);
@@ -482,6 +1180,47 @@ public:
   bool TempUpdate;
   int16_t GetTemp(void);
   char GetSpeed(void);
+#if ACAL_ENABLE
+  uint16_t AcalPer;     // , 
+  uint16_t AcalDT;      // , x0.1C
+  uint16_t AcalCount;   // 
+  uint16_t AcalSkips;   //  
+  uint16_t AcalTime;    // ,  CPU
+  uint16_t AcalTimeMax; //  ,  CPU
+  uint8_t AcalFactor;   // 
+  int8_t AcalDelta;     //    
+  void AcalRequest(void) { AcalReq = 1; }
+#endif
+#if AWD_PROT
+  void AwdControl(void);
+  uint16_t AwdTrips;      // 
+  uint16_t AwdLatency;    // ,  CPU
+  uint16_t AwdLatencyMax; //  ,  CPU
+#endif
+#if ADC_IRQ
+  uint16_t ProtTrips;      //  OVP/OCP
+  uint16_t ProtLatency;    //     ,  CPU
+  uint16_t ProtLatencyMax; //  ,  CPU
+  uint16_t GetProtSegs(void) { return(ProtSegs); }
+#endif
+  uint64_t ChargeAcc;  //, x0.001  x  
+  uint64_t EnergyAcc;  //, x0.01  x 0.001  x  
+  uint32_t EnergyTime; // ,  
+  void EnergyReset(void);
+  uint32_t GetCharge(void);
+  uint32_t GetEnergy(void);
+#if CAP_ENABLE
+  TCapture *Capture;
+#endif
+#if BENCH_ENABLE
+  uint16_t Bench(char op);
+#endif
+#if SEQ_ENABLE
+  TSequencer *Sequencer;
+#endif
+#if JRN_ENABLE
+  TJournal *Journal;
+#endif
 };
 
 //----------------------------------------------------------------------------
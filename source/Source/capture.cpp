@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------
+
+//  
+
+//-----------------------  : ------------------------------
+
+// TCapture       
+// .      DMA 
+//TOverAdc ( ADC_CIRC),    Execute()  
+// V,  V  I    .  Dec- 
+// V/I ( 12 )   3   
+//   Buff[].
+//  Arm()    (),
+//   CAP_SIZE - Pre ,   
+// (CST_DONE)     .
+//       , 
+//  CV/CC     -     (1 ).
+// RAM: CAP_SIZE * CAP_BYTES = 384 ,  Dec = 1  1.28 ,
+// Dec = 255 - 326  .
+
+//----------------------------------------------------------------------------
+
+#include "main.h"
+#include "capture.h"
+
+//----------------------------------------------------------------------------
+//----------------------------  TCapture: -------------------------------
+//----------------------------------------------------------------------------
+
+//----------------------------- : ---------------------------------
+
+TCapture::TCapture(void)
+{
+  Mode = CAP_OFF;
+  State = CST_IDLE;
+  Ptr = 0;
+  Count = 0;
+  Post = 0;
+  Pre = 0;
+  Dec = 1;
+  DecCnt = 0;
+  Level = 0;
+  Prev = 0;
+  TrigPos = 0;
+}
+
+//---------------------------  : -----------------------------
+
+//mode -  
+//dec -  (1..255)
+//level -  ,  ADC_NR
+//pre -  ,  
+
+void TCapture::Arm(char mode, uint8_t dec, uint16_t level, uint16_t pre)
+{
+  State = CST_IDLE;
+  Mode = mode;
+  Dec = dec? dec : 1;
+  DecCnt = 0;
+  Level = level;
+  Prev = level;
+  Pre = (pre < CAP_SIZE)? pre : CAP_SIZE - 1;
+  Ptr = 0;
+  Count = 0;
+  TrigPos = 0;
+  if(Mode != CAP_OFF)
+  {
+    State = CST_ARMED;
+    if(Mode == CAP_NOW) Start();
+  }
+}
+
+//------------------------------- : ------------------------------------
+
+void TCapture::Start(void)
+{
+  TrigPos = (Count < Pre)? Count : Pre;
+  Post = CAP_SIZE - TrigPos;
+  State = CST_TRIG;
+}
+
+//----------------------------  : ----------------------------------
+
+inline void TCapture::Put(uint16_t v, uint16_t i)
+{
+  uint8_t *p = &Buff[Ptr * CAP_BYTES];
+  p[0] = v;
+  p[1] = (v >> 8) | (i << 4);
+  p[2] = i >> 4;
+  if(++Ptr == CAP_SIZE) Ptr = 0;
+  if(Count < CAP_SIZE) Count++;
+}
+
+//-------------------------   : -----------------------------
+
+//v, i -   OVER_N   V  I
+
+void TCapture::Execute(const uint16_t *v, const uint16_t *i)
+{
+  if(State != CST_ARMED && State != CST_TRIG) return;
+  bool lv = (Mode == CAP_VR) || (Mode == CAP_VF);
+  bool li = (Mode == CAP_IR) || (Mode == CAP_IF);
+  bool rise = (Mode == CAP_VR) || (Mode == CAP_IR);
+  for(uint8_t n = 0; n < OVER_N; n++)
+  {
+    if(++DecCnt < Dec) continue;
+    DecCnt = 0;
+    //  :
+    if(State == CST_ARMED && (lv || li))
+    {
+      uint16_t x = lv? v[n] : i[n];
+      if(rise? (Prev < Level && x >= Level) :
+               (Prev > Level && x <= Level)) Start();
+      Prev = x;
+    }
+    Put(v[n], i[n]);
+    if(State == CST_TRIG && !--Post)
+    {
+      State = CST_DONE;
+      return;
+    }
+  }
+}
+
+//----------------------------  : -------------------------------
+
+//src -   (CAP_CVCC, CAP_PROT)
+
+void TCapture::Event(char src)
+{
+  if(State == CST_ARMED && Mode == src) Start();
+}
+
+//------------------------    : ----------------------------
+
+//n -      (0..CAP_SIZE - 1)
+//  CST_DONE  ,      Ptr.
+
+const uint8_t *TCapture::Pair(uint16_t n)
+{
+  n = n + Ptr;
+  if(n >= CAP_SIZE) n -= CAP_SIZE;
+  return(&Buff[n * CAP_BYTES]);
+}
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------
+
+//  ,  
+
+//----------------------------------------------------------------------------
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+//----------------------------------------------------------------------------
+
+#include "overadc.h"
+
+//----------------------------- : -----------------------------------
+
+#define CAP_ENABLE    1 //  on/off
+#define CAP_SIZE    128 //  ,   V/I
+#define CAP_BYTES     3 //   , 
+#define CAP_PAGE     16 //     CMD_GET_CAP
+#define CAP_PAGES (CAP_SIZE / CAP_PAGE) // 
+
+#if CAP_ENABLE && !ADC_CIRC
+  #error "Capture requires ADC_CIRC"
+#endif
+
+// :
+
+enum CapMode_t
+{
+  CAP_OFF,  // 
+  CAP_NOW,  // 
+  CAP_VR,   // V   
+  CAP_VF,   // V   
+  CAP_IR,   // I   
+  CAP_IF,   // I   
+  CAP_CVCC, // CV/CC
+  CAP_PROT, // 
+  CAP_MODES
+};
+
+// :
+
+enum CapState_t
+{
+  CST_IDLE,  //  
+  CST_ARMED, // ,  
+  CST_TRIG,  // ,   
+  CST_DONE   // 
+};
+
+//----------------------------------------------------------------------------
+//----------------------------  TCapture: -------------------------------
+//----------------------------------------------------------------------------
+
+class TCapture
+{
+private:
+  uint8_t Buff[CAP_SIZE * CAP_BYTES];
+  uint16_t Ptr;
+  uint16_t Count;
+  uint16_t Post;
+  uint16_t Pre;
+  uint8_t Dec;
+  uint8_t DecCnt;
+  uint16_t Level;
+  uint16_t Prev;
+  void Put(uint16_t v, uint16_t i);
+  void Start(void);
+public:
+  TCapture(void);
+  char Mode;
+  char State;
+  uint16_t TrigPos;
+  void Arm(char mode, uint8_t dec, uint16_t level, uint16_t pre);
+  void Execute(const uint16_t *v, const uint16_t *i);
+  void Event(char src);
+  const uint8_t *Pair(uint16_t n);
+};
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -9,6 +9,7 @@
 #include "sound.h"
 #include "data.h"
 #include "analog.h"
+#include "sched.h"
 
 //----------------------------- : ----------------------------------
 
@@ -17,6 +18,7 @@ TSound *Sound;
 TEncoder *Encoder;
 TData *Data;
 TAnalog *Analog;
+TKeyboard *Keyboard;
 
 //----------------------------------------------------------------------------
 //----------------------------  TControl: -------------------------------
@@ -37,6 +39,13 @@ TControl::TControl(void)
   Keyboard = new TKeyboard();
   Analog = new TAnalog();
   Data = new TData();
+  Analog->InitCorr(); //    EEPROM  TData
+#if SEQ_ENABLE
+  Analog->Sequencer->InitEeprom(); //  -  
+#endif
+#if JRN_ENABLE
+  Analog->Journal->InitEeprom(); //  -  
+#endif
   Menu = new TMenuItems(MENUS);
   MenuTimer = new TSoftTimer();
   MenuTimer->Oneshot = 1;
@@ -77,13 +86,18 @@ TControl::TControl(void)
 
 //------------------------  : ----------------------------
 
+//    
+//   (. main.cpp).
+
 void TControl::Execute(void)
 {
+#if !SCH_ENABLE
   Display->Execute();
   Encoder->Execute();
   Keyboard->Execute();
   Sound->Execute();
   Analog->Execute();
+#endif
 
   //   ,  
   if(Menu->SelectedMenu->MnuIndex != MnuIndex)
@@ -164,8 +178,8 @@ inline void TControl::ProtectionService(KeyMsg_t &KeyMsg)
       if(KeyMsg == KBD_OUT)
         KeyMsg = KBD_ERROR;
     }
-    //  OCP:
-    else if(ProtSt & PR_OCP)
+    //  OCP  I2t ( I2t - PAR_OCP):
+    else if(ProtSt & (PR_OCP | PR_I2T))
     {
       if(MnuIndex != MNU_PROT)
       {
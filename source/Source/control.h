@@ -21,7 +21,6 @@
 class TControl
 {
 private:
-  TKeyboard *Keyboard;
   TSoftTimer *MenuTimer;
   TMenuItems *Menu;
   Menu_t MnuIndex;
@@ -64,12 +64,22 @@ void TParam::ShowValue(void)
                  if(Value == 1) Display->PutString(" AL ");
                  if(Value == 2) Display->PutString(" On ");
                  break;
+  case PT_OFONE: if(Value == 0) Display->PutString(" OFF");
+                 if(Value == 1) Display->PutString(" On ");
+                 if(Value == 2) Display->PutString(" En ");
+                 break;
   case PT_APHPL: if(Value == 0) Display->PutString(" AG ");
                  if(Value == 1) Display->PutString(" PH ");
                  if(Value == 2) Display->PutString(" PL ");
+                 if(Value == 3) Display->PutString(" AF ");
+                 if(Value == 4) Display->PutString(" rP ");
+                 if(Value == 5) Display->PutString(" Ad ");
                  break;
   case PT_DEL:   Display->PutIntF(Value, 4, 0);
                  break;
+  case PT_I2T:   if(Value == 0) Display->PutString(" OFF");
+                   else Display->PutIntF(Value, 4, 2);
+                 break;
   case PT_T:     Display->PutIntF(Value, 3, 1);
                  Display->PutChar('*');
                  break;
@@ -152,15 +162,24 @@ void TParamList::LoadDefaults(void)
     Items[i]->Value = Items[i]->Nom;
 }
 
+//---------------------    : ----------------------------
+
+//,  ,    ExtAddr.
+
+char TParamList::Address(char n)
+{
+  return((n < ExtBase)? n : ExtAddr[n - ExtBase]);
+}
+
 //----------------------    EEPROM: -------------------------
 
 void TParamList::ReadFromEeprom(char n)
 {
   if(Items[n]->Savable())
   {
-    if(EeSection->Valid)
+    if(EeSection->Valid && (n < ExtBase || ExtValid))
     {
-      Items[n]->Value = EeSection->Read(n);
+      Items[n]->Value = EeSection->Read(Address(n));
       Items[n]->Validate();
     }
     else
@@ -173,20 +192,37 @@ void TParamList::ReadFromEeprom(char n)
 
 //------------------     EEPROM: ---------------------
 
+//  EXT_MARK (EEPROM  ) , 
+//,    .
+
 void TParamList::ReadFromEeprom(void)
 {
+  ExtValid = ExtAddr && EeSection->Valid &&
+    (EeSection->Read(ExtAddr[ItemsCount - ExtBase]) == EXT_MARK);
   for(char i = 0; i < ItemsCount; i++)
     ReadFromEeprom(i);
+  if(!ExtValid) SaveMark();
   if(!EeSection->Valid)
     EeSection->Validate();
 }
 
+//------------------   ,  : ----------
+
+void TParamList::SaveMark(void)
+{
+  if(ExtAddr)
+  {
+    EeSection->Update(ExtAddr[ItemsCount - ExtBase], EXT_MARK);
+    ExtValid = 1;
+  }
+}
+
 //---------------------  a  EEPROM: -----------------------
 
 void TParamList::SaveToEeprom(char n)
 {
   if(Items[n]->Savable())
-    EeSection->Update(n, Items[n]->Value);
+    EeSection->Update(Address(n), Items[n]->Value);
 }
 
 //-----------------     EEPROM: -------------------
@@ -195,6 +231,7 @@ void TParamList::SaveToEeprom(void)
 {
   for(char i = 0; i < ItemsCount; i++)
     SaveToEeprom(i);
+  SaveMark();
   EeSection->Validate();
 }
 
@@ -241,11 +278,11 @@ TData::TData(void)
   SetupData->AddItem(new TParam(PT_TIM,   "t-",    0,   0, TIMMAX));   //PAR_TIM
   SetupData->AddItem(new TParam(PT_FALN,  "trc-",  0,   2,   2));   //PAR_TRC
   SetupData->AddItem(new TParam(PT_OFFON, "Con-",  0,   0,   1));   //PAR_CON
-  SetupData->AddItem(new TParam(PT_OFFON, " P- ",  0,   0,   1));   //PAR_POW
+  SetupData->AddItem(new TParam(PT_OFONE, " P- ",  0,   0,   2));   //PAR_POW
   SetupData->AddItem(new TParam(PT_OFFON, "SEt-",  0,   1,   1));   //PAR_SET
   SetupData->AddItem(new TParam(PT_OFFON, "GEt-",  0,   0,   1));   //PAR_GET
-  SetupData->AddItem(new TParam(PT_APHPL, "APU-",  0,   0,   2));   //PAR_APV
-  SetupData->AddItem(new TParam(PT_APHPL, "APC-",  0,   0,   2));   //PAR_APC
+  SetupData->AddItem(new TParam(PT_APHPL, "APU-",  0,   0,   5));   //PAR_APV
+  SetupData->AddItem(new TParam(PT_APHPL, "APC-",  0,   0,   5));   //PAR_APC
   SetupData->AddItem(new TParam(PT_OFFON, "PrC-",  0,   0,   1));   //PAR_PRC
   SetupData->AddItem(new TParam(PT_OFFON, "dnP-",  0,   0,   1));   //PAR_DNP
   SetupData->AddItem(new TParam(PT_OFFON, "Out-",  0,   0,   1));   //PAR_OUT
@@ -256,7 +293,16 @@ TData::TData(void)
   SetupData->AddItem(new TParam(PT_NY,    "dEF-",  0,   0,   1));   //PAR_DEF
   SetupData->AddItem(new TParam(PT_NY,    "CAL-",  0,   0,   1));   //PAR_CAL
   SetupData->AddItem(new TParam(PT_NY,    "ESC-",  1,   1,   1));   //PAR_ESC
-  SetupData->EeSection = new TEeSection(SetupData->ItemsCount);
+  SetupData->AddItem(new TParam(PT_PRV,   "-SrU",  1, VMAX, VMAX)); //PAR_SRV
+  SetupData->AddItem(new TParam(PT_PRI,   "SrC-",  1, IMAX, IMAX)); //PAR_SRI
+  SetupData->AddItem(new TParam(PT_I2T,   "I2t-",  0,   0, I2TMAX)); //PAR_I2T
+  SetupData->EeSection = new TEeSection(PARS_BASE);
+  //    PAR_SRV, PAR_SRI, PAR_I2T
+  //  EXT_MARK:
+  static const char SETUP_EXT[PARS_SETUP - PARS_BASE + 1] =
+    { PAR_CALL, PAR_STOR, PAR_INF, PAR_ESC };
+  SetupData->ExtAddr = SETUP_EXT;
+  SetupData->ExtBase = PARS_BASE;
   SetupData->ReadFromEeprom();
 
   //   V   :
@@ -284,6 +330,7 @@ void TData::TrimParamsLimits(void)
   SetupData->Items[PAR_OCP]->Validate();
   SetupData->Items[PAR_OPP]->Max = TopData->Items[PAR_MAXP]->Value;
   SetupData->Items[PAR_OPP]->Validate();
+  Analog->ProtChanged();
 }
 
 //--------------------------  : ---------------------------
@@ -296,10 +343,24 @@ void TData::Apply(char par)
     switch(par)
     {
     case PAR_TIM: Analog->OffTime = val; break;
+    case PAR_OVP:
+    case PAR_OCP:
+    case PAR_OPP:
+    case PAR_DEL:
+    case PAR_I2T: Analog->ProtChanged();
+#if AWD_PROT
+                  Analog->AwdControl();
+#endif
+                  break;
     case PAR_APV: Analog->AdcV->SetMode(val); break;
     case PAR_APC: Analog->AdcI->SetMode(val); break;
-    case PAR_DNP: Analog->OutControl(Analog->OutState()); break;
+    case PAR_DNP: Analog->ProtChanged();
+                  Analog->OutControl(Analog->OutState());
+                  break;
     case PAR_OUT: if(val == ON) Data->SaveV(); break;
+    // ,  Max -   (OFF):
+    case PAR_SRV: Analog->DacV->SetRate((val < VMAX)? val : 0); break;
+    case PAR_SRI: Analog->DacI->SetRate((val < IMAX)? val : 0); break;
     case PAR_SND: Sound->SetMode((SndMode_t)val); break;
     case PAR_ENR: Encoder->Rev = val; break;
     case PAR_DEF: if(val == YES)
@@ -359,9 +420,11 @@ void TData::SaveV(void)
 
 void TData::SetVI(void)
 {
+  Analog->DacV->Hold(1); //V  I    
   Analog->DacV->SetValue(MainData->Items[PAR_V]->Value); // DAC_V
   Analog->DacI->SetValue(MainData->Items[PAR_I]->Value); // DAC_I
   Analog->OutControl(OutOn); //OUT and DP ON/OFF
+  Analog->DacV->Hold(0);
 }
 
 //----------------------  : -----------------------------
@@ -375,10 +438,15 @@ inline void TData::InitPresets(void)
 
   if(!(PresetV->Valid && PresetI->Valid))
   {
+    //   ( V  RING_OLD ):
+    uint16_t b = PresetV->GetBase() + RING_OLD - RING_V;
+    TEeSection ov(PRESETS, b);
+    TEeSection oi(PRESETS, b + PRESETS + 1);
+    bool old = ov.Valid && oi.Valid;
     for(char i = 0; i < PRESETS; i++)
     {
-      PresetV->Update(i, PRE_V_INIT[i]);
-      PresetI->Update(i, PRE_I_INIT);
+      PresetV->Update(i, old? ov.Read(i) : PRE_V_INIT[i]);
+      PresetI->Update(i, old? oi.Read(i) : PRE_I_INIT);
     }
     PresetV->Validate();
     PresetI->Validate();
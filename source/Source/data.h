@@ -15,9 +15,23 @@
 //------------------------------- : ---------------------------------
 
 #define PRESETS 10 // 
-#define RING_V 160 //   V
+#define RING_V 70 //   V
+#define RING_OLD 160 //   V  
+
+// EEPROM 24C04 (256 ,  -  + ):
+// 15, Top 4, Main 4, Setup 30,  V 71,  22,
+//  36,   28,   46
+//(JRN_RECS 3).
+// EEPROM   V.   V   
+//,   24C04 1 .     
+// RING_V / 2 .  (35 .  RING_V = 70).
+//     RING_OLD :   
+//     (InitPresets),  
+//V .
+//,   ,  ER_ALLOC    EEPROM.
 
 #define DMAX   999 //.   , 
+#define I2TMAX 9999 //.   I2t, x0.01 A^2
 
 #define TMIN   200 //.   , x0.1C
 #define TMAX   999 //.   , x0.1C
@@ -69,11 +83,11 @@ enum SetupData_t
   PAR_TIM,  //Timer
   PAR_TRC,  //Track (OFF/AUTOLOCK/ON)
   PAR_CON,  //Confirm (OFF/ON)
-  PAR_POW,  //Display power (OFF/ON)
+  PAR_POW,  //Display power (OFF/ON/ENERGY)
   PAR_SET,  //Display setpoint when regulated (OFF/ON)
   PAR_GET,  //Always display maesured values(OFF/ON)
-  PAR_APV,  //Display average/peak V (AVERAGE/PEAK HIGH/PEAK LOW)
-  PAR_APC,  //Display average/peak I (AVERAGE/PEAK HIGH/PEAK LOW)
+  PAR_APV,  //Display average/peak V (AVERAGE/PEAK HIGH/PEAK LOW/AVERAGE FAST/RIPPLE/ADAPTIVE)
+  PAR_APC,  //Display average/peak I (AVERAGE/PEAK HIGH/PEAK LOW/AVERAGE FAST/RIPPLE/ADAPTIVE)
   PAR_PRC,  //Current preview (OFF/ON)
   PAR_DNP,  //Down programmer (OFF/ON)
   PAR_OUT,  //Restore out state (OFF/ON)
@@ -84,9 +98,18 @@ enum SetupData_t
   PAR_DEF,  //Load defaults
   PAR_CAL,  //Calibration (NO/YES/DEFAULT)
   PAR_ESC,  //Escape menu (NO/YES)
+  //,  ,     ,
+  //   ,    
+  //  (     TMenuSetup):
+  PAR_SRV,  //Soft-start V slew rate
+  PAR_SRI,  //Soft-start I slew rate
+  PAR_I2T,  //OCP I2t budget (OFF - instant OCP)
   PARS_SETUP
 };
 
+#define PARS_BASE (PAR_ESC + 1) //   Setup
+#define EXT_MARK 0xE5A1 // ,  
+
 enum ParType_t // 
 {
   PT_V,     //, x0.01 V
@@ -100,8 +123,10 @@ enum ParType_t //
   PT_PRE,   //CALL/STORE (NOSAVE)
   PT_OFFON, //OFF/ON
   PT_FALN,  //OFF/ALARM/ON
-  PT_APHPL, //AVERAGE/PEAK HIGH/PEAK LOW
+  PT_OFONE, //OFF/ON/ENERGY
+  PT_APHPL, //AVERAGE/PEAK HIGH/PEAK LOW/AVERAGE FAST/RIPPLE/ADAPTIVE
   PT_DEL,   //, 
+  PT_I2T,   // I2t, x0.01 A^2s (0 - OFF)
   PT_T,     //, x0.1C
   PT_FIRM,  //Firmware Version (NOSAVE)
   PT_NY,    //  (NOSAVE)
@@ -111,6 +136,7 @@ enum ParType_t //
 
 enum OffOn_t { OFF, ON };
 enum Track_t { TRCOFF, TRCAUTO, TRCON };
+enum PowDisp_t { POWOFF, POWON, POWEN };
 enum NoYes_t { NO, YES, DEFAULT };
 
 #define PROT_FLAG 0x80 //  
@@ -180,9 +206,15 @@ void TList<T>::AddItem(T *t)
 class TParamList : public TList<TParam>
 {
 private:
+  bool ExtValid; // EXT_MARK 
+  char Address(char n);
+  void SaveMark(void);
 public:
-  TParamList(char max) : TList(max) {};
+  TParamList(char max) : TList(max), ExtValid(0), ExtAddr(0),
+    ExtBase(max) {};
   TEeSection *EeSection;
+  const char *ExtAddr; //   ExtBase,  EXT_MARK
+  char ExtBase;        //  ,  
   void LoadDefaults(void);
   void ReadFromEeprom(char n);
   void ReadFromEeprom(void);
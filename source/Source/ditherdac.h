@@ -6,8 +6,12 @@
 
 //   (DAC1  DAC2),  
 //       ,
-// Delta-Sigma   .   
-//  13  24     .  
+// Delta-Sigma     
+//(DAC_ORDER).  DAC_RES     16  20 ,
+//   2^(DAC_RES - 12),  RAM - 4 * 2^(DAC_RES - 12)
+//   (16  - 64 , 18  - 256, 20  - 1024). 
+// TScaler   16-  (DAC_MAX_CODE),   
+//DAC_EXT   .  
 //Delta-Sigma    DAC_FS. , 
 //  ,    .  12    ,
 //   -  Delta-Sigma .  
@@ -15,6 +19,29 @@
 // .       DMA
 //  DAC    .   DMA
 //DMA1_Channel2  DMA1_Channel3.     TIM3.
+//    DAC_MAX_FINE   
+//   ( TDsStep, TDsPat)    flash
+//  TDsBank (DAC_RES 16 - 512 , 18 - 8 ).   
+//     ,   
+//  32- .  DAC_RES 20     flash,
+//    .
+//  DAC_DUAL  DAC1  DAC2    
+//TDualTable  32- ,    DMA1_Channel2
+//   DAC->DHR12RD.     
+//,   DMA1_Channel3,   
+// DMA.
+// : DMA  ,   
+// .       DMA
+//    (TC),    
+//       .  
+//   DMA    , 
+//  .     
+// .   
+//  ,   ,  
+//  .     .
+//   (),  , 
+// ,      
+//.        .
 
 //----------------------------------------------------------------------------
 
@@ -24,11 +51,162 @@
 //----------------------------- : -----------------------------------
 
 #define DAC_NR           12 //Native DAC Resolution, bits
-#define DAC_RES          16 //Dither DAC Resolution, bits
+#ifndef DAC_RES //     (  )
+  #define DAC_RES        16 //Dither DAC Resolution, bits (16..20)
+#endif
+#define DAC_ORDER         2 //Delta-Sigma Modulator Order (1 or 2)
+#define DAC_CR           16 //Scaler Code Resolution, bits
 #define DAC_FS       200000 //Delta-Sigma Sampling Frequency, Hz
+#define DAC_EXT (DAC_RES - DAC_CR) //extra DAC code bits
 #define DAC_MAX_FINE (1 << (DAC_RES - DAC_NR)) //max fine part code
-#define DAC_MAX_CODE ((1 << DAC_RES) - DAC_MAX_FINE) //max DAC code
+#define DAC_MAX_CODE ((1 << DAC_CR) - (1 << (DAC_CR - DAC_NR))) //max code
+#define DAC_MAX_DITH ((uint32_t)DAC_MAX_CODE << DAC_EXT) //max DAC code
 #define DAC_BUFFER        1 //DAC buffer on/off
+#define DAC_IRQ_PRI       1 //   
+#define DAC_PER (SYSTEM_CORE_CLOCK / DAC_FS) // , 
+#define DAC_SWAP_CYC     40 //      Swap
+
+#define DAC_BANK (DAC_RES <= 18) //   flash
+#define DAC_DUAL          0 //  DAC1  DAC2 (DHR12RD) on/off
+#define DAC_STEP (DAC_DUAL + 1) //    
+
+#if (DAC_RES < DAC_CR) || (DAC_RES > 20)
+  #error "DAC_RES must be 16..20"
+#endif
+
+//----------------------------------------------------------------------------
+//-------------   Delta-Sigma : -------------
+//----------------------------------------------------------------------------
+
+#if DAC_BANK
+
+//   I      F.
+//O1, Sg -    (, ),
+//C1, S1, C2, S2 -   MASH 1-1 (, ).
+
+template<uint16_t F, uint16_t I>
+struct TDsStep
+{
+  typedef TDsStep<F, I - 1> P;
+  enum
+  {
+    O1 = P::Sg > DAC_MAX_FINE,
+    Sg = P::Sg + F - O1 * DAC_MAX_FINE,
+    C1 = P::S1 + F >= DAC_MAX_FINE,
+    S1 = P::S1 + F - C1 * DAC_MAX_FINE,
+    C2 = P::S2 + S1 >= DAC_MAX_FINE,
+    S2 = P::S2 + S1 - C2 * DAC_MAX_FINE
+  };
+};
+
+template<uint16_t F>
+struct TDsStep<F, 0>
+{
+  enum
+  {
+    O1 = 0, Sg = DAC_MAX_FINE,
+    C1 = 0, S1 = DAC_MAX_FINE / 2,
+    C2 = 0, S2 = 0
+  };
+};
+
+// I      F.  
+//   Out + 1 (0..3),    Coarse - 1.
+
+template<uint16_t F, uint16_t I>
+struct TDsPat
+{
+  typedef TDsStep<F, I + 1> S;
+  typedef TDsStep<F, (I? I : DAC_MAX_FINE)> Pre;
+#if DAC_ORDER == 2
+  enum { Out = S::C1 + S::C2 - Pre::C2 + 1 };
+#else
+  enum { Out = S::O1 };
+#endif
+};
+
+// :  F  DAC_MAX_FINE / 2 ,
+//     ( - ).
+
+#define DS_W(F, K) (TDsPat<F, 2 * (K)>::Out | \
+  (uint32_t)TDsPat<F, 2 * (K) + 1>::Out << 16),
+#define DS_W4(F, K) DS_W(F, K) DS_W(F, K + 1) DS_W(F, K + 2) DS_W(F, K + 3)
+#define DS_W8(F, K) DS_W4(F, K) DS_W4(F, K + 4)
+#define DS_W32(F, K) DS_W8(F, K) DS_W8(F, K + 8) \
+  DS_W8(F, K + 16) DS_W8(F, K + 24)
+
+#if DAC_RES == 16
+  #define DS_ROW(F) DS_W8(F, 0)
+#elif DAC_RES == 18
+  #define DS_ROW(F) DS_W32(F, 0)
+#else
+  #error "DAC_BANK supports DAC_RES 16 or 18"
+#endif
+
+#define DS_R4(F) DS_ROW(F) DS_ROW(F + 1) DS_ROW(F + 2) DS_ROW(F + 3)
+#define DS_R16(F) DS_R4(F) DS_R4(F + 4) DS_R4(F + 8) DS_R4(F + 12)
+#define DS_R64(F) DS_R16(F) DS_R16(F + 16) DS_R16(F + 32) DS_R16(F + 48)
+
+//       ,
+//   .
+
+template<uint8_t Order>
+struct TDsBank
+{
+  static const uint32_t Data[DAC_MAX_FINE * DAC_MAX_FINE / 2];
+};
+
+template<uint8_t Order>
+const uint32_t TDsBank<Order>::Data[DAC_MAX_FINE * DAC_MAX_FINE / 2] =
+{
+#if DAC_RES == 16
+  DS_R16(0)
+#else
+  DS_R64(0)
+#endif
+};
+
+#endif
+
+//----------------------------------------------------------------------------
+//-----------------------   DAC1  DAC2: -------------------------
+//----------------------------------------------------------------------------
+
+#if DAC_DUAL
+
+//     -  DAC1,  - DAC2.
+//      .
+
+template<uint8_t Dummy>
+struct TDualTable
+{
+  static uint32_t Table[2][DAC_MAX_FINE];
+  static bool Active;                 //   
+  static uint32_t * volatile Pending; //,  
+  static uint8_t Hold;                //  
+  static volatile bool Busy;          //  
+  static volatile bool Redo[2];       //   
+  static volatile uint32_t Next[2];   //  
+};
+
+template<uint8_t Dummy>
+uint32_t TDualTable<Dummy>::Table[2][DAC_MAX_FINE];
+template<uint8_t Dummy>
+bool TDualTable<Dummy>::Active = 0;
+template<uint8_t Dummy>
+uint32_t * volatile TDualTable<Dummy>::Pending = 0;
+template<uint8_t Dummy>
+uint8_t TDualTable<Dummy>::Hold = 0;
+template<uint8_t Dummy>
+volatile bool TDualTable<Dummy>::Busy = 0;
+template<uint8_t Dummy>
+volatile bool TDualTable<Dummy>::Redo[2];
+template<uint8_t Dummy>
+volatile uint32_t TDualTable<Dummy>::Next[2];
+
+typedef TDualTable<0> TDual;
+
+#endif
 
 //----------------------------------------------------------------------------
 //-----------------------   TDitherDac: ------------------------
@@ -36,18 +214,50 @@
 
 //DacN = 0 - DAC1, DacN = 1 - DAC2
 
+extern "C" void DMA1_Channel2_IRQHandler(void);
+extern "C" void DMA1_Channel3_IRQHandler(void);
+
 template<uint8_t DacN>
 class TDitherDac
 {
 private:
+  friend void DMA1_Channel2_IRQHandler(void);
+  friend void DMA1_Channel3_IRQHandler(void);
   TGpio<PORTA, DacN? PIN5 : PIN4> Pin_DAC; 
-  uint16_t DitherTable[DAC_MAX_FINE];
+#if !DAC_DUAL
+  union //    
+  {
+    uint32_t DitherWords[2][DAC_MAX_FINE / 2];
+    uint16_t DitherTable[2][DAC_MAX_FINE];
+  };
+  bool Active; //  
+  static uint16_t * volatile Pending; //,  
+  static volatile bool Busy;          //  
+  static volatile bool Redo;          //   
+  static volatile uint32_t Next;      //  
+#endif
+  static void Swap(void);
+  static void Sigma1(uint16_t *t, uint16_t Coarse, uint16_t Fine);
+  static void Sigma2(uint16_t *t, uint16_t Coarse, uint16_t Fine);
 public:
   TDitherDac(void) {};
   void Init(void);
-  void operator = (uint16_t Value);
+  void operator = (uint32_t Value);
+  static void Hold(bool on);
+  static void Fill(uint16_t *t, uint16_t Coarse, uint16_t Fine);
 };
 
+#if !DAC_DUAL
+template<uint8_t DacN>
+uint16_t * volatile TDitherDac<DacN>::Pending = 0;
+template<uint8_t DacN>
+volatile bool TDitherDac<DacN>::Busy = 0;
+template<uint8_t DacN>
+volatile bool TDitherDac<DacN>::Redo = 0;
+template<uint8_t DacN>
+volatile uint32_t TDitherDac<DacN>::Next = 0;
+#endif
+
 //---------------------------- : --------------------------------
 
 template<uint8_t DacN>
@@ -60,7 +270,7 @@ void TDitherDac<DacN>::Init(void)
   
   TIM3->CR1 &= ~TIM_CR1_CEN;          // 
   TIM3->PSC = 0;                      // 
-  TIM3->ARR = (SYSTEM_CORE_CLOCK / DAC_FS) - 1; // 
+  TIM3->ARR = DAC_PER - 1;            // 
   
   if(DacN == 0) // ,   
   {
@@ -73,15 +283,20 @@ void TDitherDac<DacN>::Init(void)
       DAC_CR_BOFF1     * DAC_BUFFER | //buffer on/off
       DAC_CR_EN1       * 1;  //DAC1 enable
     
-    DMA1_Channel2->CPAR = (uint32_t)&DAC->DHR12R1; //periph. address
-    DMA1_Channel2->CMAR = (uint32_t)&DitherTable;  //memory address
+#if DAC_DUAL
+    DMA1_Channel2->CPAR = (uint32_t)(uintptr_t)&DAC->DHR12RD; //periph. addr.
+    DMA1_Channel2->CMAR = (uint32_t)(uintptr_t)TDual::Table[0]; //memory addr.
+#else
+    DMA1_Channel2->CPAR = (uint32_t)(uintptr_t)&DAC->DHR12R1; //periph. addr.
+    DMA1_Channel2->CMAR = (uint32_t)(uintptr_t)DitherTable[0]; //memory addr.
+#endif
     DMA1_Channel2->CNDTR = DAC_MAX_FINE;           //buffer size
     
     DMA1_Channel2->CCR =
       DMA_CCR2_MEM2MEM * 0 |          //memory to memory off
       DMA_CCR2_PL_0    * 2 |          //high priority
-      DMA_CCR2_MSIZE_0 * 1 |          //mem. size 16 bit
-      DMA_CCR2_PSIZE_0 * 1 |          //periph. size 16 bit
+      DMA_CCR2_MSIZE_0 * DAC_STEP |   //mem. size 16/32 bit
+      DMA_CCR2_PSIZE_0 * DAC_STEP |   //periph. size 16/32 bit
       DMA_CCR2_MINC    * 1 |          //memory increment enable
       DMA_CCR2_PINC    * 0 |          //periph. increment disable
       DMA_CCR2_CIRC    * 1 |          //circular mode
@@ -93,6 +308,8 @@ void TDitherDac<DacN>::Init(void)
    
     TIM3->CCR3 = 0;                   //CC3 register load
     TIM3->DIER |= TIM_DIER_CC3DE;     //CC3 DMA request enable
+    NVIC_SetPriority(DMA1_Channel2_IRQn, DAC_IRQ_PRI);
+    NVIC_EnableIRQ(DMA1_Channel2_IRQn);
   }
   if(DacN == 1) // ,   
   {
@@ -104,9 +321,10 @@ void TDitherDac<DacN>::Init(void)
       DAC_CR_TEN2      * 0 | //trigger disable
       DAC_CR_BOFF2     * DAC_BUFFER | //buffer on/off
       DAC_CR_EN2       * 1;  //DAC2 enable
+#if !DAC_DUAL
     
-    DMA1_Channel3->CPAR = (uint32_t)&DAC->DHR12R2; //periph. address
-    DMA1_Channel3->CMAR = (uint32_t)&DitherTable;  //memory address
+    DMA1_Channel3->CPAR = (uint32_t)(uintptr_t)&DAC->DHR12R2; //periph. addr.
+    DMA1_Channel3->CMAR = (uint32_t)(uintptr_t)DitherTable[0]; //memory addr.
     DMA1_Channel3->CNDTR = DAC_MAX_FINE;           //buffer size
     
     DMA1_Channel3->CCR =
@@ -125,23 +343,170 @@ void TDitherDac<DacN>::Init(void)
 
     TIM3->CCR4 = TIM3->ARR / 2;       //CC4 register load
     TIM3->DIER |= TIM_DIER_CC4DE;     //CC4 DMA request enable
+    NVIC_SetPriority(DMA1_Channel3_IRQn, DAC_IRQ_PRI);
+    NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+#endif
   }
-  for(uint8_t i = 0; i < DAC_MAX_FINE; i++)
-    DitherTable[i] = 0;               //clear DitherTable
+#if DAC_DUAL
+  for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+    TDual::Table[0][i] = TDual::Table[1][i] = 0; //clear DitherTable
+  TDual::Active = 0;
+#else
+  for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+    DitherTable[0][i] = DitherTable[1][i] = 0; //clear DitherTable
+  Active = 0;
+#endif
   TIM3->CR1 = TIM_CR1_CEN;            //timer 3 enable
 }
 
 //------------------------------ : -----------------------------------
 
 template<uint8_t DacN>
-void TDitherDac<DacN>::operator = (uint16_t Value)
+void TDitherDac<DacN>::operator = (uint32_t Value)
 {
   // :
-  if(Value > DAC_MAX_CODE) Value = DAC_MAX_CODE;
-  //     :
-  uint16_t Coarse = Value >> (DAC_RES - DAC_NR);
-  uint16_t Fine = Value & (DAC_MAX_FINE - 1);
-  //Delta-Sigma :
+  if(Value > DAC_MAX_DITH) Value = DAC_MAX_DITH;
+  //      ( ),
+  //,   ,   :
+#if DAC_DUAL
+  TDual::Next[DacN] = Value;
+  if(TDual::Busy) { TDual::Redo[DacN] = 1; return; }
+  TDual::Busy = 1;
+#else
+  Next = Value;
+  if(Busy) { Redo = 1; return; }
+  Busy = 1;
+#endif
+  //     :
+  __istate_t s = __get_interrupt_state();
+  __disable_interrupt();
+#if DAC_DUAL
+  DMA1_Channel2->CCR &= ~DMA_CCR2_TCIE;
+#else
+  if(DacN == 0) DMA1_Channel2->CCR &= ~DMA_CCR2_TCIE;
+  if(DacN == 1) DMA1_Channel3->CCR &= ~DMA_CCR3_TCIE;
+#endif
+  __set_interrupt_state(s);
+#if DAC_DUAL
+  // ,  ,   ,
+  //     :
+  uint32_t *Words = TDual::Pending;
+  if(!Words)
+  {
+    Words = TDual::Table[!TDual::Active];
+    for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+      Words[i] = TDual::Table[TDual::Active][i];
+  }
+  //   ,    :
+  bool Ch[2] = { DacN == 0, DacN == 1 };
+  do
+  {
+    __set_interrupt_state(s);
+    for(uint8_t c = 0; c < 2; c++)
+    {
+      if(!Ch[c]) continue;
+      TDual::Redo[c] = 0;
+      uint32_t v = TDual::Next[c];
+      Fill((uint16_t *)Words + c,
+           v >> (DAC_RES - DAC_NR), v & (DAC_MAX_FINE - 1));
+    }
+    __disable_interrupt();
+    Ch[0] = TDual::Redo[0];
+    Ch[1] = TDual::Redo[1];
+  }
+  while(Ch[0] || Ch[1]);
+  //     :
+  TDual::Active = Words == TDual::Table[1];
+  TDual::Pending = Words;
+  if(!TDual::Hold)
+  {
+    DMA1->IFCR = DMA_IFCR_CTCIF2;
+    DMA1_Channel2->CCR |= DMA_CCR2_TCIE;
+  }
+  TDual::Busy = 0;
+#else
+  //    ,  ,
+  //,        :
+  uint16_t *Table = Pending? Pending : DitherTable[!Active];
+  do
+  {
+    __set_interrupt_state(s);
+    Redo = 0;
+    uint32_t v = Next;
+    Fill(Table, v >> (DAC_RES - DAC_NR), v & (DAC_MAX_FINE - 1));
+    __disable_interrupt();
+  }
+  while(Redo);
+  //     :
+  Active = Table == DitherTable[1];
+  Pending = Table;
+  if(DacN == 0) // ,   
+  {
+    DMA1->IFCR = DMA_IFCR_CTCIF2;
+    DMA1_Channel2->CCR |= DMA_CCR2_TCIE;
+  }
+  if(DacN == 1) // ,   
+  {
+    DMA1->IFCR = DMA_IFCR_CTCIF3;
+    DMA1_Channel3->CCR |= DMA_CCR3_TCIE;
+  }
+  Busy = 0;
+#endif
+  __set_interrupt_state(s);
+  //for(uint16_t i = 0; i < DAC_MAX_FINE; i++) //Sawtooth test
+  //  DitherTable[i] = i * 16;             
+  //if(DacN == 0) DAC->DHR12R1 = Value;        //Direct load test (DAC 0)
+  //if(DacN == 1) DAC->DHR12R2 = Value;        //Direct load test (DAC 1) 
+}
+
+//--------------------   : ------------------------
+
+//t -   (  DAC_STEP,   )
+//Coarse, Fine -     
+
+template<uint8_t DacN>
+inline void TDitherDac<DacN>::Fill(uint16_t *t, uint16_t Coarse,
+                                   uint16_t Fine)
+{
+#if DAC_ORDER == 2
+  //       (Coarse - 1..Coarse + 2)
+  //    ,     :
+  if(Coarse && Coarse < (1 << DAC_NR) - 2)
+#endif
+  {
+#if DAC_BANK
+    //   +   :
+    const uint32_t *Pat = TDsBank<DAC_ORDER>::Data + Fine * DAC_MAX_FINE / 2;
+#if DAC_DUAL
+    const uint16_t *p = (const uint16_t *)Pat;
+    uint16_t Base = Coarse - (DAC_ORDER - 1);
+    for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+      t[i * 2] = p[i] + Base;
+#else
+    uint32_t *Words = (uint32_t *)t;
+    uint32_t Base = (Coarse - (DAC_ORDER - 1)) * 0x00010001;
+    for(uint16_t i = 0; i < DAC_MAX_FINE / 2; i++)
+      Words[i] = Pat[i] + Base;
+#endif
+#elif DAC_ORDER == 2
+    Sigma2(t, Coarse, Fine);
+#else
+    Sigma1(t, Coarse, Fine);
+#endif
+  }
+#if DAC_ORDER == 2
+  else
+  {
+    Sigma1(t, Coarse, Fine);
+  }
+#endif
+}
+
+//------------------ Delta-Sigma   : ------------------
+
+template<uint8_t DacN>
+void TDitherDac<DacN>::Sigma1(uint16_t *t, uint16_t Coarse, uint16_t Fine)
+{
   int16_t Delta, Sigma = DAC_MAX_FINE;
   uint16_t Out;
   for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
@@ -152,12 +517,137 @@ void TDitherDac<DacN>::operator = (uint16_t Value)
     //:
     Sigma = Sigma + Fine + Delta;
     // :
-    DitherTable[i] = Out;
+    t[i * DAC_STEP] = Out;
   }
-  //for(uint16_t i = 0; i < DAC_MAX_FINE; i++) //Sawtooth test
-  //  DitherTable[i] = i * 16;             
-  //if(DacN == 0) DAC->DHR12R1 = Value;        //Direct load test (DAC 0)
-  //if(DacN == 1) DAC->DHR12R2 = Value;        //Direct load test (DAC 1) 
+}
+
+//------------------ Delta-Sigma   : ------------------
+
+// MASH 1-1:    Fine,  - 
+// . : Coarse + C1(n) + C2(n) - C2(n - 1). 
+//      ,   
+//         
+//Coarse + Fine / DAC_MAX_FINE.     
+//       .
+
+template<uint8_t DacN>
+void TDitherDac<DacN>::Sigma2(uint16_t *t, uint16_t Coarse, uint16_t Fine)
+{
+  uint16_t S1 = DAC_MAX_FINE / 2, S2 = 0, c;
+  //  ( 0 - C1,  1 - C2):
+  for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+  {
+    c = 0;
+    S1 += Fine;
+    if(S1 >= DAC_MAX_FINE) { S1 -= DAC_MAX_FINE; c = 1; }
+    S2 += S1;
+    if(S2 >= DAC_MAX_FINE) { S2 -= DAC_MAX_FINE; c |= 2; }
+    t[i * DAC_STEP] = c;
+  }
+  // :
+  uint16_t Pre = t[(DAC_MAX_FINE - 1) * DAC_STEP] >> 1;
+  for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+  {
+    c = t[i * DAC_STEP];
+    t[i * DAC_STEP] = Coarse + (c & 1) + (c >> 1) - Pre;
+    Pre = c >> 1;
+  }
+}
+
+//-------------------------  : -----------------------------
+
+//   DMA    . 
+//    ,   DMA   
+//     (CNDTR)     DMA
+// (TIM3 CC3 - DAC1, CC4 - DAC2)   DAC_SWAP_CYC
+//.  (  ) TC ,
+//     , 
+//    .    
+//  .    TC (
+// NVIC) .
+
+template<uint8_t DacN>
+inline void TDitherDac<DacN>::Swap(void)
+{
+#if DAC_DUAL
+  //    DMA1_Channel2,
+  //  (TCIE )   :
+  if(DacN || !(DMA1->ISR & DMA_ISR_TCIF2) || !TDual::Pending ||
+     !(DMA1_Channel2->CCR & DMA_CCR2_TCIE)) return;
+  DMA1->IFCR = DMA_IFCR_CTCIF2;
+  __istate_t s = __get_interrupt_state();
+  __disable_interrupt();
+  //    DMA :
+  uint16_t d = DAC_PER - TIM3->CNT;
+  if(d >= DAC_PER) d -= DAC_PER;
+  if(d > DAC_SWAP_CYC && DMA1_Channel2->CNDTR == DAC_MAX_FINE)
+  {
+    DMA1_Channel2->CCR &= ~(DMA_CCR2_EN | DMA_CCR2_TCIE);
+    DMA1_Channel2->CMAR = (uint32_t)(uintptr_t)TDual::Pending;
+    DMA1_Channel2->CNDTR = DAC_MAX_FINE;
+    DMA1_Channel2->CCR |= DMA_CCR2_EN;
+    TDual::Pending = 0;
+  }
+  __set_interrupt_state(s);
+#else
+  //    (TCIE ) 
+  // ,       NVIC :
+  if(!(DMA1->ISR & (DacN? DMA_ISR_TCIF3 : DMA_ISR_TCIF2)) || !Pending ||
+     !(DacN? DMA1_Channel3->CCR & DMA_CCR3_TCIE :
+             DMA1_Channel2->CCR & DMA_CCR2_TCIE)) return;
+  DMA1->IFCR = DacN? DMA_IFCR_CTCIF3 : DMA_IFCR_CTCIF2;
+  __istate_t s = __get_interrupt_state();
+  __disable_interrupt();
+  //    DMA :
+  uint16_t d = (DacN? (DAC_PER - 1) / 2 : 0) + DAC_PER - TIM3->CNT;
+  if(d >= DAC_PER) d -= DAC_PER;
+  if(DacN == 0 && d > DAC_SWAP_CYC &&
+     DMA1_Channel2->CNDTR == DAC_MAX_FINE)
+  {
+    DMA1_Channel2->CCR &= ~(DMA_CCR2_EN | DMA_CCR2_TCIE);
+    DMA1_Channel2->CMAR = (uint32_t)(uintptr_t)Pending;
+    DMA1_Channel2->CNDTR = DAC_MAX_FINE;
+    DMA1_Channel2->CCR |= DMA_CCR2_EN;
+    Pending = 0;
+  }
+  if(DacN == 1 && d > DAC_SWAP_CYC &&
+     DMA1_Channel3->CNDTR == DAC_MAX_FINE)
+  {
+    DMA1_Channel3->CCR &= ~(DMA_CCR3_EN | DMA_CCR3_TCIE);
+    DMA1_Channel3->CMAR = (uint32_t)(uintptr_t)Pending;
+    DMA1_Channel3->CNDTR = DAC_MAX_FINE;
+    DMA1_Channel3->CCR |= DMA_CCR3_EN;
+    Pending = 0;
+  }
+  __set_interrupt_state(s);
+#endif
+}
+
+//-------------------   : -------------------------
+
+//  DAC_DUAL     Hold(1)  Hold(0) 
+//         .   
+//.      ,  
+// .
+
+template<uint8_t DacN>
+void TDitherDac<DacN>::Hold(bool on)
+{
+#if DAC_DUAL
+  if(on)
+  {
+    DMA1_Channel2->CCR &= ~DMA_CCR2_TCIE;
+    TDual::Hold++;
+  }
+  //      :
+  else if(TDual::Hold && !--TDual::Hold && TDual::Pending && !TDual::Busy)
+  {
+    DMA1->IFCR = DMA_IFCR_CTCIF2;
+    DMA1_Channel2->CCR |= DMA_CCR2_TCIE;
+  }
+#else
+  (void)on;
+#endif
 }
 
 //----------------------------------------------------------------------------
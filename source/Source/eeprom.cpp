@@ -129,7 +129,7 @@ TEeSection::TEeSection(uint16_t size)
   Sign = Base + size; // 
   EeTop = Sign + 1;   //    EEPROM
   Valid = 1;
-  if(EeTop > EEPROM_SIZE)
+  if(EeTop > EEPROM_WORDS)
   {
     TEeprom::Error |= ER_ALLOC;
     Valid = 0;
@@ -142,6 +142,19 @@ TEeSection::TEeSection(uint16_t size)
   if(!Valid) TEeprom::Error |= ES_PLAIN;
 }
 
+//-------------------     base: ---------------------
+
+//      EEPROM:
+//  ,    .
+
+TEeSection::TEeSection(uint16_t size, uint16_t base)
+{
+  Base = base;
+  Size = size;
+  Sign = Base + size;
+  Valid = (Sign < EEPROM_WORDS) && (TEeprom::Read(Sign) == EE_SIGNATURE);
+}
+
 //-------------------------  : ----------------------------
 
 void TEeSection::Validate(void)
@@ -186,7 +199,7 @@ TCrcSection::TCrcSection(uint16_t size) : TEeSection(size)
 {
   Crc = EeTop;     // CRC
   EeTop = Crc + 1; //    EEPROM
-  if(EeTop > EEPROM_SIZE)
+  if(EeTop > EEPROM_WORDS)
   {
     TEeprom::Error |= ER_ALLOC;
     Valid = 0;
@@ -14,6 +14,7 @@
 //----------------------------- : -----------------------------------
 
 #define EEPROM_SIZE 512 //   2404, 
+#define EEPROM_WORDS (EEPROM_SIZE / 2) //   ( )
 
 //  EEPROM:
 
@@ -62,7 +63,9 @@ protected:
   uint16_t Sign;
 public:
   TEeSection(uint16_t size);
+  TEeSection(uint16_t size, uint16_t base);
   bool Valid;
+  uint16_t GetBase(void) { return(Base); }
   virtual void Validate(void);
   uint16_t Read(uint16_t addr);
   void Write(uint16_t addr, uint16_t data);
@@ -0,0 +1,168 @@
+//----------------------------------------------------------------------------
+
+//   
+
+//-----------------------  : ------------------------------
+
+// TJournal   EEPROM   JRN_RECS   
+// OVP/OCP/OPP/OTP/I2t.     , 
+// , ,  V  I   JRN_N
+//  V  I  .  
+// RAM     (Sample).    
+//  RAM (Event),  EEPROM    
+//     JRN_WRTM  (Execute),   
+//        EEPROM.
+//   ,   ,  
+//:        
+//.      ( Lost).
+// EEPROM: JRN_RECS * JRN_WORDS + 1 .
+
+//----------------------------------------------------------------------------
+
+#include "main.h"
+#include "journal.h"
+
+//----------------------------------------------------------------------------
+//----------------------------  TJournal: -------------------------------
+//----------------------------------------------------------------------------
+
+//----------------------------- : ---------------------------------
+
+TJournal::TJournal(void)
+{
+  EeSection = 0;
+  WrTimer = new TSoftTimer(JRN_WRTM);
+  for(char k = 0; k < JRN_N; k++)
+  {
+    HistV[k] = 0;
+    HistI[k] = 0;
+  }
+  HistPtr = 0;
+  WrPos = JRN_IDLE;
+  Next = 0;
+  Seq = 0;
+  Count = 0;
+  Lost = 0;
+}
+
+//------------------------    EEPROM: -------------------------
+
+//   EEPROM   .
+//   EEPROM   ,  .
+
+void TJournal::InitEeprom(void)
+{
+  uint8_t e = TEeprom::Error;
+  EeSection = new TEeSection(JRN_RECS * JRN_WORDS);
+  if(!EeSection->Valid)
+  {
+    if(TEeprom::Error & ER_ALLOC)
+    {
+      EeSection = 0;
+      return;
+    }
+    TEeprom::Error = e;
+    for(char k = 0; k < JRN_RECS; k++)
+      EeSection->Write(k * JRN_WORDS + JW_SEQ, JRN_EMPTY);
+    EeSection->Validate();
+  }
+  //  :
+  for(char k = 0; k < JRN_RECS; k++)
+  {
+    uint16_t s = EeSection->Read(k * JRN_WORDS + JW_SEQ);
+    if(s == JRN_EMPTY) continue;
+    if(!Count || (int16_t)(s - Seq) >= 0)
+    {
+      Seq = s + 1;
+      Next = k + 1;
+    }
+    Count++;
+  }
+  if(Seq == JRN_EMPTY) Seq = 0;
+  if(Next == JRN_RECS) Next = 0;
+}
+
+//-------------------------   V  I: ----------------------------
+
+//    .
+
+void TJournal::Sample(uint16_t v, uint16_t i)
+{
+  HistV[HistPtr] = v;
+  HistI[HistPtr] = i;
+  if(++HistPtr == JRN_N) HistPtr = 0;
+}
+
+//------------------------  : ------------------------------
+
+//flags -   , temp - ,
+//v, i - .    RAM.
+
+void TJournal::Event(char flags, int16_t temp, uint16_t v, uint16_t i)
+{
+  if(!EeSection) return;
+  if(WrPos != JRN_IDLE)
+  {
+    Lost++;
+    return;
+  }
+  uint32_t t = TSysTimer::GetCounter();
+  Rec[JW_SEQ] = Seq;
+  Rec[JW_TLO] = (uint16_t)t;
+  Rec[JW_THI] = t >> 16;
+  Rec[JW_FLAG] = flags;
+  Rec[JW_TEMP] = temp;
+  Rec[JW_SETV] = v;
+  Rec[JW_SETI] = i;
+  //HistPtr     :
+  for(char k = 0; k < JRN_N; k++)
+  {
+    uint8_t p = (HistPtr + k) % JRN_N;
+    Rec[JW_V + k] = HistV[p];
+    Rec[JW_I + k] = HistI[p];
+  }
+  WrPos = 0;
+  WrTimer->Start(JRN_WRTM);
+}
+
+//----------------------    EEPROM: -------------------------
+
+void TJournal::Execute(void)
+{
+  if(WrPos == JRN_IDLE || !WrTimer->Over()) return;
+  uint16_t a = Next * JRN_WORDS;
+  if(WrPos == 0)
+  {
+    //   :
+    if(Count == JRN_RECS) Count--;
+    EeSection->Write(a + JW_SEQ, JRN_EMPTY);
+  }
+  else if(WrPos < JRN_WORDS)
+  {
+    EeSection->Write(a + WrPos, Rec[WrPos]);
+  }
+  else
+  {
+    //  ,   :
+    EeSection->Write(a + JW_SEQ, Rec[JW_SEQ]);
+    if(++Next == JRN_RECS) Next = 0;
+    if(++Seq == JRN_EMPTY) Seq = 0;
+    Count++;
+    WrPos = JRN_IDLE;
+    return;
+  }
+  WrPos++;
+  WrTimer->Start(JRN_WRTM);
+}
+
+//---------------------------  : ---------------------------------
+
+//n -   (0 - , n < Count), w -   JrnWord_t.
+
+uint16_t TJournal::Read(uint8_t n, uint8_t w)
+{
+  uint8_t k = (Next + JRN_RECS - 1 - n) % JRN_RECS;
+  return(EeSection->Read(k * JRN_WORDS + w));
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+//----------------------------------------------------------------------------
+
+//   ,  
+
+//----------------------------------------------------------------------------
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+//----------------------------------------------------------------------------
+
+#include "eeprom.h"
+
+//----------------------------- : -----------------------------------
+
+#define JRN_ENABLE    1 //   on/off
+#define JRN_N         4 //   V  I  
+#define JRN_RECS      3 //   EEPROM (. data.h)
+#define JRN_WRTM     10 //    EEPROM, 
+
+//  :
+
+enum JrnWord_t
+{
+  JW_SEQ,               //  (0xFFFF - )
+  JW_TLO,               //  , ,  
+  JW_THI,               //  , ,  
+  JW_FLAG,              //   PrState_t
+  JW_TEMP,              //, x0.1C
+  JW_SETV,              // V, x0.01 
+  JW_SETI,              // I, x0.001 
+  JW_V,                 //JRN_N  FastValue V,    
+  JW_I = JW_V + JRN_N,  //JRN_N  FastValue I,    
+  JRN_WORDS = JW_I + JRN_N
+};
+
+#define JRN_EMPTY 0xFFFF //  
+#define JRN_IDLE  0xFF   //  EEPROM  
+
+//----------------------------------------------------------------------------
+//----------------------------  TJournal: -------------------------------
+//----------------------------------------------------------------------------
+
+class TJournal
+{
+private:
+  TEeSection *EeSection;
+  TSoftTimer *WrTimer;
+  uint16_t HistV[JRN_N];
+  uint16_t HistI[JRN_N];
+  uint8_t HistPtr;
+  uint16_t Rec[JRN_WORDS]; //,    EEPROM
+  uint8_t WrPos;           //  , JRN_IDLE - 
+  uint8_t Next;            //    
+  uint16_t Seq;            //  
+public:
+  TJournal(void);
+  uint8_t Count;           //   EEPROM
+  uint16_t Lost;           //,      EEPROM
+  void InitEeprom(void);
+  void Sample(uint16_t v, uint16_t i);
+  void Event(char flags, int16_t temp, uint16_t v, uint16_t i);
+  void Execute(void);
+  uint16_t Read(uint8_t n, uint8_t w);
+};
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -54,4 +54,8 @@ public:
 
 //----------------------------------------------------------------------------
 
+extern TKeyboard *Keyboard;
+
+//----------------------------------------------------------------------------
+
 #endif
@@ -0,0 +1,212 @@
+//----------------------------------------------------------------------------
+
+//  
+
+//-----------------------  : ------------------------------
+
+// TLogger     RAM.  
+//Interval     Buff[]  , 
+//,  , , ,   
+//.        :
+// ,    .  
+//   varint,   -   
+//    zigzag varint (7   ,  
+//-  ).     .
+//        Base, 
+//       Base 
+//.    , First -  
+// , Count -  .   
+//   - 1..5 ,    100..500 .
+
+//----------------------------------------------------------------------------
+
+#include "main.h"
+#include "logger.h"
+
+//----------------------------------------------------------------------------
+//-----------------------------  TLogger: -------------------------------
+//----------------------------------------------------------------------------
+
+//----------------------------- : ---------------------------------
+
+TLogger::TLogger(void)
+{
+  Start(0);
+}
+
+//--------------------------  : ----------------------------
+
+//t -  ,  (0 -  )
+//   .
+
+void TLogger::Start(uint16_t t)
+{
+  Interval = t;
+  Head = 0;
+  Tail = 0;
+  Used = 0;
+  SecCnt = 0;
+  Time = 0;
+  First = 0;
+  Count = 0;
+}
+
+//---------------------------  : ----------------------------
+
+bool TLogger::Due(void)
+{
+  if(!TSysTimer::SecTick || !Interval) return(0);
+  Time++;
+  if(++SecCnt < Interval) return(0);
+  SecCnt = 0;
+  return(1);
+}
+
+//---------------------------  : -----------------------------
+
+// Time   .
+
+void TLogger::Add(LogRec_t &r)
+{
+  r.Time = Time;
+  if(!Count)
+  {
+    Base = r;
+  }
+  else
+  {
+    uint8_t p[LOG_REC_MAX];
+    uint8_t n = Pack(p, r);
+    while(LOG_SIZE - Used < n) Drop();
+    for(uint8_t i = 0; i < n; i++)
+    {
+      Buff[Head] = p[i];
+      if(++Head == LOG_SIZE) Head = 0;
+    }
+    Used += n;
+  }
+  Last = r;
+  Count++;
+}
+
+//-------------------------   : --------------------------
+
+void TLogger::Drop(void)
+{
+  uint16_t pos = Unpack(Tail, Base);
+  Used -= (pos >= Tail)? pos - Tail : pos + LOG_SIZE - Tail;
+  Tail = pos;
+  First++;
+  Count--;
+}
+
+//----------------------------  : ------------------------------
+
+static uint8_t PutVar(uint8_t *p, uint32_t x)
+{
+  uint8_t n = 0;
+  while(x >= 0x80)
+  {
+    p[n++] = (x & 0x7F) | 0x80;
+    x >>= 7;
+  }
+  p[n++] = x;
+  return(n);
+}
+
+static inline uint32_t Zig(int32_t d)
+{
+  return((d << 1) ^ (d >> 31));
+}
+
+static inline int32_t Unzig(uint32_t z)
+{
+  return((z >> 1) ^ -(int32_t)(z & 1));
+}
+
+uint8_t TLogger::Pack(uint8_t *p, LogRec_t &r)
+{
+  uint8_t n = 1;
+  uint8_t m = 0;
+  uint32_t dt = r.Time - Last.Time;
+  if(dt != Interval) { m |= LM_DT; n += PutVar(&p[n], dt); }
+  if(r.S != Last.S) { m |= LM_S; p[n++] = r.S; }
+  if(r.V != Last.V) { m |= LM_V; n += PutVar(&p[n], Zig(r.V - Last.V)); }
+  if(r.I != Last.I) { m |= LM_I; n += PutVar(&p[n], Zig(r.I - Last.I)); }
+  if(r.P != Last.P) { m |= LM_P; n += PutVar(&p[n], Zig(r.P - Last.P)); }
+  if(r.T != Last.T) { m |= LM_T; n += PutVar(&p[n], Zig(r.T - Last.T)); }
+  p[0] = m;
+  return(n);
+}
+
+//---------------------------  : -----------------------------
+
+//pos -     
+//r -  ,  
+//   .
+
+uint16_t TLogger::Unpack(uint16_t pos, LogRec_t &r)
+{
+  uint8_t m = Buff[pos];
+  if(++pos == LOG_SIZE) pos = 0;
+  uint32_t v[6];
+  for(uint8_t f = 0; f < 6; f++)
+  {
+    v[f] = 0;
+    if(m & (1 << f))
+    {
+      uint8_t s = 0, b;
+      do
+      {
+        b = Buff[pos];
+        if(++pos == LOG_SIZE) pos = 0;
+        v[f] |= (uint32_t)(b & 0x7F) << s;
+        s += 7;
+      }
+      while(b & 0x80);
+    }
+  }
+  r.Time += (m & LM_DT)? v[0] : Interval;
+  if(m & LM_S) r.S = v[1];
+  r.V += Unzig(v[2]);
+  r.I += Unzig(v[3]);
+  r.P += Unzig(v[4]);
+  r.T += Unzig(v[5]);
+  return(pos);
+}
+
+//------------------------------  : -------------------------------
+
+//n -  ,   First..First + Count - 1
+//r -  
+//pos -    
+//   .
+
+uint32_t TLogger::Seek(uint32_t n, LogRec_t &r, uint16_t &pos)
+{
+  if(n < First) n = First;
+  if(n >= First + Count) n = First + Count - 1;
+  r = Base;
+  pos = Tail;
+  for(uint32_t k = First; k < n; k++)
+    pos = Unpack(pos, r);
+  return(n);
+}
+
+//---------------------------  : ------------------------------
+
+uint16_t TLogger::Next(uint16_t pos, LogRec_t &r)
+{
+  return(Unpack(pos, r));
+}
+
+//-------------------------   : -----------------------------
+
+uint8_t TLogger::Byte(uint16_t pos)
+{
+  return(Buff[pos % LOG_SIZE]);
+}
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
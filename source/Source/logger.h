@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------------
+
+//  ,  
+
+//----------------------------------------------------------------------------
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+//----------------------------- : -----------------------------------
+
+#define LOG_ENABLE    1 //  on/off
+#define LOG_SIZE    512 //  , 
+#define LOG_REC_MAX  19 //   , 
+#define LOG_REC_SIZE 13 //    , 
+
+//    :
+
+enum LogMask_t
+{
+  LM_DT = 0x01, //   Interval
+  LM_S  = 0x02, //  
+  LM_V  = 0x04, // 
+  LM_I  = 0x08, // 
+  LM_P  = 0x10, // 
+  LM_T  = 0x20  // 
+};
+
+// :
+
+typedef struct
+{
+  uint32_t Time; //   , 
+  uint16_t V;    //, x0.01 
+  uint16_t I;    //, x0.001 
+  uint16_t P;    //, x0.1 
+  int16_t T;     //, x0.1C
+  uint8_t S;     //  (  CMD_GET_STAT)
+} LogRec_t;
+
+//----------------------------------------------------------------------------
+//-----------------------------  TLogger: -------------------------------
+//----------------------------------------------------------------------------
+
+class TLogger
+{
+private:
+  uint8_t Buff[LOG_SIZE];
+  uint16_t Head;
+  uint16_t Tail;
+  uint16_t Used;
+  uint16_t SecCnt;
+  uint32_t Time;
+  LogRec_t Base;
+  LogRec_t Last;
+  uint8_t Pack(uint8_t *p, LogRec_t &r);
+  uint16_t Unpack(uint16_t pos, LogRec_t &r);
+  void Drop(void);
+public:
+  TLogger(void);
+  uint16_t Interval;
+  uint32_t First;
+  uint32_t Count;
+  void Start(uint16_t t);
+  bool Due(void);
+  void Add(LogRec_t &r);
+  uint32_t Seek(uint32_t n, LogRec_t &r, uint16_t &pos);
+  uint16_t Next(uint16_t pos, LogRec_t &r);
+  uint8_t Byte(uint16_t pos);
+};
+
+//----------------------------------------------------------------------------
+
+#endif
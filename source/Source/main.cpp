@@ -9,11 +9,114 @@
 #include "main.h"
 #include "control.h"
 #include "port.h"
+#include "sched.h"
+#include "display.h"
+#include "sound.h"
+#include "analog.h"
+#include <stddef.h>
+
+//----------------------------- : -----------------------------------
+
+#define HEAP_SIZE 0x1700 //   , 
+
+//  (8 ):  0x800,  HEAP_SIZE,  -
+//  (~160 ).    
+//(CAP_ENABLE, 402 )   (LOG_ENABLE, 568 )
+// ~5780  ,     200 .
 
 //----------------------------- : ----------------------------------
 
 TControl *Control;
 TPort *Port;
+#if SCH_ENABLE
+TScheduler *Scheduler;
+#endif
+
+//-----------------------------  : -------------------------------
+
+#if SCH_ENABLE
+
+static void AnalogTask(void)   { Analog->Execute(); }
+static void EncoderTask(void)  { Encoder->Execute(); }
+static void KeyboardTask(void) { Keyboard->Execute(); }
+static void ControlTask(void)  { Control->Execute(); }
+static void DisplayTask(void)  { Display->Execute(); }
+static void SoundTask(void)    { Sound->Execute(); }
+static void PortTask(void)     { Port->Execute(); }
+
+//       CMD_GET_SCH.
+
+static const Task_t TaskTable[] =
+{
+  //       .    
+  { AnalogTask,   0,     1,     1,    SEV_ADC  }, // 
+  { EncoderTask,  1,     1,     1,    SEV_NONE }, // 
+  { KeyboardTask, 2,     10,    10,   SEV_NONE }, // 
+  { ControlTask,  3,     1,     5,    SEV_NONE }, //
+  { DisplayTask,  4,     1,     2,    SEV_NONE }, //
+  { SoundTask,    5,     1,     5,    SEV_NONE }, //
+  { PortTask,     6,     1,     10,   SEV_NONE }  //  
+};
+
+#define TASKS (sizeof(TaskTable) / sizeof(Task_t))
+
+#endif
+
+//------------------------  : ------------------------------
+
+//        ,  
+//   :    
+// 8 ,  .    6  
+//  ~130 .    - HeapUsed.
+//  -  ,    :
+//  ,   "Err-" "HEAP".
+
+static uint64_t Heap[HEAP_SIZE / 8];
+uint16_t HeapUsed = 0;
+
+//   .   ,  
+//       ,  
+//     (Pin_ON).
+
+static void HeapError(void)
+{
+  if(Display)
+  {
+    Display->Blink(BLINK_NO);
+    Display->SetPos(0, 0);
+    Display->PutString("Err-");
+    Display->SetPos(1, 0);
+    Display->PutString("HEAP");
+  }
+  do
+  {
+    TSysTimer::Sync();
+    if(Display) Display->Execute();
+  }
+  while(1);
+}
+
+void *operator new(size_t size)
+{
+  size = (size + 7) & ~7;
+  if(size > HEAP_SIZE - HeapUsed) HeapError(); // 
+  void *p = (uint8_t *)Heap + HeapUsed;
+  HeapUsed += size;
+  return(p);
+}
+
+void *operator new[](size_t size)
+{
+  return(operator new(size));
+}
+
+void operator delete(void *p)
+{
+}
+
+void operator delete[](void *p)
+{
+}
 
 //----------------------------------------------------------------------------
 //-------------------------  : ------------------------------
@@ -24,13 +127,20 @@ int main(void)
   TSysTimer::Init();        //  
   Control = new TControl(); //  
   Port = new TPort();       //  
+#if SCH_ENABLE
+  Scheduler = new TScheduler(TaskTable, TASKS); // 
+#endif
   TSysTimer::SecReset();    //  
   
   do                        // 
   {
+#if SCH_ENABLE
+    Scheduler->Execute();   //  
+#else
     TSysTimer::Sync();      //     
     Control->Execute();     //  
     Port->Execute();        //  
+#endif
   }
   while(1);
 }
@@ -175,7 +175,8 @@ void TMenuMain::Init(void)
 void TMenuMain::Execute(void)
 {
   // P:
-  bool Power = Data->SetupData->Items[PAR_POW]->Value == ON;
+  bool Power = Data->SetupData->Items[PAR_POW]->Value == POWON;
+  bool Energy = Data->SetupData->Items[PAR_POW]->Value == POWEN;
   if(Power && ((Analog->AdcV->Query() && Analog->AdcI->Query()) || ForceV))
   {
     uint32_t p = (uint32_t)Analog->AdcV->Value * Analog->AdcI->Value / 100;
@@ -200,10 +201,28 @@ void TMenuMain::Execute(void)
     }
     ForceV = 0; ForceI = 0;
   }
+  //   :
+  if(Energy && ((Analog->AdcV->Query() && Analog->AdcI->Query()) || ForceV))
+  {
+    Analog->AdcV->Sync();
+    Analog->AdcI->Sync();
+    //     V,      I:
+    if(!(Edit && ParIndex == PAR_V))
+    {
+      Display->SetPos(0, 0);
+      Display->PutIntF(Analog->GetEnergy() / 10, 4, 3 + AUTO_SCALE);
+    }
+    if(!(Edit && ParIndex == PAR_I))
+    {
+      Display->SetPos(1, 0);
+      Display->PutIntF(Analog->GetCharge() / 1000, 4, 3 + AUTO_SCALE);
+    }
+    ForceV = 0; ForceI = 0;
+  }
   // V:
   //      V  ,
   //    V
-  if(!Power && (Analog->AdcV->Ready() || ForceV) && !(Edit && ParIndex == PAR_V))
+  if(!Power && !Energy && (Analog->AdcV->Ready() || ForceV) && !(Edit && ParIndex == PAR_V))
   {
        //     
     if((Data->SetupData->Items[PAR_GET]->Value == ON) ||
@@ -227,7 +246,7 @@ void TMenuMain::Execute(void)
   }
   // I:
   // I  ,     I
-  if(!Power && Analog->AdcI->FastUpdate && !(Edit && ParIndex == PAR_I))
+  if(!Power && !Energy && Analog->AdcI->FastUpdate && !(Edit && ParIndex == PAR_I))
   {
     //  :
     bool dnp = Analog->AdcI->FastCode < Analog->DP_Code;
@@ -407,8 +426,9 @@ void TMenuMain::OnKeyboard(KeyMsg_t &msg)
   }
   if(msg == KBD_SETVI)
   {
-    Data->SetupData->Items[PAR_POW]->Value =
-    !Data->SetupData->Items[PAR_POW]->Value;
+    // OFF -> P -> ENERGY -> OFF:
+    TParam *p = Data->SetupData->Items[PAR_POW];
+    p->Value = (p->Value < p->Max)? p->Value + 1 : p->Min;
     Data->SetupData->SaveToEeprom(PAR_POW);
     msg = KBD_NOP;
     return;
@@ -773,6 +793,18 @@ void TMenuSetup::OnKeyboard(KeyMsg_t &msg)
 
 //--------------------------  : -------------------------------
 
+//   . ,  ,   
+//SetupData_t,      , ESC - .
+
+static const char SetupOrder[PARS_SETUP] =
+{
+  PAR_CALL, PAR_STOR, PAR_LOCK, PAR_OVP, PAR_OCP, PAR_OPP, PAR_DEL,
+  PAR_I2T, PAR_OTP, PAR_FNL, PAR_FNH, PAR_HST, PAR_TIM, PAR_TRC,
+  PAR_CON, PAR_POW, PAR_SET, PAR_GET, PAR_APV, PAR_APC, PAR_PRC,
+  PAR_DNP, PAR_OUT, PAR_SRV, PAR_SRI, PAR_SND, PAR_ENR, PAR_SPL,
+  PAR_INF, PAR_DEF, PAR_CAL, PAR_ESC
+};
+
 void TMenuSetup::OnEncoder(int8_t &step)
 {
   // :
@@ -794,15 +826,19 @@ void TMenuSetup::OnEncoder(int8_t &step)
   //   :
   else
   {
-    if(step > 0 && ParIndex < Params->ItemsCount - 1)
+    char k = 0;
+    while(k < PARS_SETUP - 1 && SetupOrder[k] != ParIndex) k++;
+    if(step > 0 && k < PARS_SETUP - 1)
     {
-      LoadParam(Params->Items[++ParIndex]);
+      ParIndex = SetupOrder[k + 1];
+      LoadParam(Params->Items[ParIndex]);
       ActiveIndex = ParIndex;
       step = ENC_NOP;
     }
-    if(step < 0 && ParIndex > 0)
+    if(step < 0 && k > 0)
     {
-      LoadParam(Params->Items[--ParIndex]);
+      ParIndex = SetupOrder[k - 1];
+      LoadParam(Params->Items[ParIndex]);
       ActiveIndex = ParIndex;
       step = ENC_NOP;
     }
@@ -871,7 +907,7 @@ void TMenuProt::Execute(void)
     char ProtSt = Analog->GetProtSt();
     //  (,     PC):
     if((ParIndex == PAR_OVP && !(ProtSt & PR_OVP)) ||
-       (ParIndex == PAR_OCP && !(ProtSt & PR_OCP)) ||
+       (ParIndex == PAR_OCP && !(ProtSt & (PR_OCP | PR_I2T))) ||
        (ParIndex == PAR_OPP && !(ProtSt & PR_OPP)) ||
        (ParIndex == PAR_OTP && !(ProtSt & PR_OTP)))
     {
@@ -17,6 +17,28 @@
 //       AdcGetCode, 
 //    .
 //       ADC_RES.
+// ADC_CIRC = 1 DMA       
+//.       HTIF/TCIF,
+//   ,  .  
+//,   .     
+// DMA     ,   
+//,   Overrun.   
+//     (  ,  
+//),     DMA (CNDTR),  
+//  ,  DMA .
+//         
+// ,    Min  Max (  ADC_RES),  
+// Sum    Sum2   (  ADC_NR).
+// Block     .  
+//ADC_CIRC      DMA  
+//, ..    .
+// ADC_IRQ = 1  HTIF7/TCIF7   1 
+// DMA  7,      
+//Done.     1    Done
+//    Taken.    ,
+//  ,    , 
+//   Overrun.   
+//  Analog.
 
 //----------------------------------------------------------------------------
 
@@ -30,6 +52,18 @@
 #define ADC_FS        100000 //Sampling frequency, Hz
 #define ADC_MAX_CODE  ((1 << ADC_RES) - (1 << (ADC_RES - ADC_NR)))
 #define OVER_N        100 //Oversampling ratio
+#define ADC_CIRC        1 //circular DMA (double buffering) on/off
+#define ADC_IRQ         1 //    1 on/off
+
+#if ADC_IRQ && !ADC_CIRC
+  #error "ADC_IRQ requires ADC_CIRC"
+#endif
+
+#if ADC_CIRC
+  #define ADC_BUFF (OVER_N * 2) //  
+#else
+  #define ADC_BUFF OVER_N       //  
+#endif
 
 //  :
 
@@ -45,6 +79,21 @@ enum smp_t
   SMP239T5
 };
 
+#define ADC_CAL_MASK 0x7F //    ADC1->DR
+
+//-----------------------------  : ------------------------------
+
+//   ,      
+//.       ADC1->DR.
+
+inline void AdcCalibrate(void)
+{
+  ADC1->CR2 |= ADC_CR2_RSTCAL;        //ADC calibration reset
+  while(ADC1->CR2 & ADC_CR2_RSTCAL);
+  ADC1->CR2 |= ADC_CR2_CAL;           //ADC calibration
+  while(ADC1->CR2 & ADC_CR2_CAL);
+}
+
 //----------------------------------------------------------------------------
 //------------------------   TOverAdc: -------------------------
 //----------------------------------------------------------------------------
@@ -57,14 +106,35 @@ class TOverAdc
 {
 private:
   TGpio<PORTA, AdcPin> Pin_ADC;
-  uint16_t Samples[OVER_N];
+  uint16_t Samples[ADC_BUFF];
+#if ADC_CIRC
+  bool Half; //  ,  
+#endif
+#if ADC_IRQ
+  uint8_t Taken; //   (  256)
+#endif
 public:
   TOverAdc(void) {};
   void Init(void);
   bool Ready(void);
   operator uint16_t();
+  uint32_t Overrun; //  
+  uint16_t Min;     //   
+  uint16_t Max;     //   
+  uint32_t Sum;     //   
+  uint32_t Sum2;    //    
+  const uint16_t *Block; //   ( ADC_NR)
+  const uint16_t *Part(bool h) { return(&Samples[h? OVER_N : 0]); }
+#if ADC_IRQ
+  static volatile uint8_t Done; //  
+#endif
 };
 
+#if ADC_IRQ
+template<uint8_t AdcN, uint8_t AdcPin>
+volatile uint8_t TOverAdc<AdcN, AdcPin>::Done;
+#endif
+
 //---------------------------- : --------------------------------
 
 template<uint8_t AdcN, uint8_t AdcPin>
@@ -82,7 +152,7 @@ void TOverAdc<AdcN, AdcPin>::Init(void)
   
   ADC1->CR1 =
     ADC_CR1_AWDEN      * 0 |          //reg. analog watchdog disable
-    ADC_CR1_JAWDEN     * 0 |          //inj. analog watchdog disable
+    ADC_CR1_JAWDEN     * 0 |          //inj. analog watchdog (see AWD_PROT)
     ADC_CR1_DISCNUM_0  * 0 |          //no disc. mode channels
     ADC_CR1_JDISCEN    * 0 |          //inj. disc. mode disable
     ADC_CR1_DISCEN     * 0 |          //reg. disc. mode disable
@@ -109,10 +179,7 @@ void TOverAdc<AdcN, AdcPin>::Init(void)
     ADC_CR2_CONT       * 0 |          //continuous conversion
     ADC_CR2_ADON       * 1;           //ADC enable
 
-  ADC1->CR2 |= ADC_CR2_RSTCAL;        //ADC calibration reset
-  while(ADC1->CR2 & ADC_CR2_RSTCAL);
-  ADC1->CR2 |= ADC_CR2_CAL;           //ADC calibration
-  while(ADC1->CR2 & ADC_CR2_CAL);
+  AdcCalibrate();
   
   RCC->APB1ENR |= RCC_APB1ENR_TIM2EN; //  TIM2
   TIM2->CR1 &= ~TIM_CR1_CEN;          // 
@@ -127,9 +194,9 @@ void TOverAdc<AdcN, AdcPin>::Init(void)
   if(AdcN == 0) // ,   
   {
     RCC->AHBENR |= RCC_AHBENR_DMA1EN;
-    DMA1_Channel5->CPAR = (uint32_t)&ADC1->JDR1; //periph. address
-    DMA1_Channel5->CMAR = (uint32_t)&Samples;    //memory address
-    DMA1_Channel5->CNDTR = OVER_N;               //buffer size
+    DMA1_Channel5->CPAR = (uint32_t)(uintptr_t)&ADC1->JDR1; //periph. addr.
+    DMA1_Channel5->CMAR = (uint32_t)(uintptr_t)&Samples;    //memory addr.
+    DMA1_Channel5->CNDTR = ADC_BUFF;             //buffer size
     
     DMA1_Channel5->CCR =
       DMA_CCR5_MEM2MEM * 0 |          //memory to memory off
@@ -138,7 +205,7 @@ void TOverAdc<AdcN, AdcPin>::Init(void)
       DMA_CCR5_PSIZE_0 * 1 |          //periph. size 16 bit
       DMA_CCR5_MINC    * 1 |          //memory increment enable
       DMA_CCR5_PINC    * 0 |          //periph. increment disable
-      DMA_CCR5_CIRC    * 0 |          //circular mode disable
+      DMA_CCR5_CIRC    * ADC_CIRC |   //circular mode on/off
       DMA_CCR5_DIR     * 0 |          //direction - from periph.
       DMA_CCR5_TEIE    * 0 |          //transfer error interrupt disable
       DMA_CCR5_HTIE    * 0 |          //half transfer interrupt disable
@@ -151,9 +218,9 @@ void TOverAdc<AdcN, AdcPin>::Init(void)
   if(AdcN == 1) // ,   
   {
     RCC->AHBENR |= RCC_AHBENR_DMA1EN;
-    DMA1_Channel7->CPAR = (uint32_t)&ADC1->JDR2; //periph. address
-    DMA1_Channel7->CMAR = (uint32_t)&Samples;    //memory address
-    DMA1_Channel7->CNDTR = OVER_N;               //buffer size
+    DMA1_Channel7->CPAR = (uint32_t)(uintptr_t)&ADC1->JDR2; //periph. addr.
+    DMA1_Channel7->CMAR = (uint32_t)(uintptr_t)&Samples;    //memory addr.
+    DMA1_Channel7->CNDTR = ADC_BUFF;             //buffer size
     
     DMA1_Channel7->CCR =
       DMA_CCR7_MEM2MEM * 0 |          //memory to memory off
@@ -162,16 +229,26 @@ void TOverAdc<AdcN, AdcPin>::Init(void)
       DMA_CCR7_PSIZE_0 * 1 |          //periph. size 16 bit
       DMA_CCR7_MINC    * 1 |          //memory increment enable
       DMA_CCR7_PINC    * 0 |          //periph. increment disable
-      DMA_CCR7_CIRC    * 0 |          //circular mode disable
+      DMA_CCR7_CIRC    * ADC_CIRC |   //circular mode on/off
       DMA_CCR7_DIR     * 0 |          //direction - from periph.
       DMA_CCR7_TEIE    * 0 |          //transfer error interrupt disable
-      DMA_CCR7_HTIE    * 0 |          //half transfer interrupt disable
-      DMA_CCR7_TCIE    * 0 |          //transfer complete interrupt disable
+      DMA_CCR7_HTIE    * ADC_IRQ |    //half transfer interrupt (ADC_IRQ)
+      DMA_CCR7_TCIE    * ADC_IRQ |    //transfer complete interrupt (ADC_IRQ)
       DMA_CCR7_EN      * 1;           //DMA enable
     
     TIM2->CCR2 = TIM2->ARR;           //CC2 register load
     TIM2->DIER |= TIM_DIER_CC2DE;     //CC2 DMA request enable
   }
+#if ADC_CIRC
+  Half = 0;
+#endif
+#if ADC_IRQ
+  Taken = Done;
+#endif
+  Overrun = 0;
+  Min = Max = 0;
+  Sum = Sum2 = 0;
+  Block = Samples;
   TIM2->CR1 |= TIM_CR1_CEN;           //timer 2 enable
 }
 
@@ -180,6 +257,12 @@ void TOverAdc<AdcN, AdcPin>::Init(void)
 template<uint8_t AdcN, uint8_t AdcPin>
 inline bool TOverAdc<AdcN, AdcPin>::Ready(void)
 {
+#if ADC_IRQ
+  if(AdcN == 1) return((uint8_t)(Done - Taken));
+#endif
+#if ADC_CIRC
+  if(!Half) return(DMA1->ISR & (AdcN? DMA_ISR_HTIF7 : DMA_ISR_HTIF5));
+#endif
   return(DMA1->ISR & (AdcN? DMA_ISR_TCIF7 : DMA_ISR_TCIF5));
 }
 
@@ -189,8 +272,68 @@ template<uint8_t AdcN, uint8_t AdcCh>
 inline TOverAdc<AdcN, AdcCh>::operator uint16_t()
 {
   int32_t Avg = 0;
+#if ADC_IRQ
+  if(AdcN == 1) // ,   
+  {
+    // ,   :
+    uint8_t m = Done - Taken;
+    if(m > 1)
+    {
+      Overrun += m - 1;
+      Taken += m - 1;
+      if(!(m & 1)) Half = !Half;
+    }
+  }
+#endif
+#if ADC_CIRC
+  uint16_t *s = &Samples[Half? OVER_N : 0];
+#else
+  uint16_t *s = Samples;
+#endif
+  //,  ,      :
+  uint32_t Avg2 = 0;
+  uint16_t mn = s[0];
+  uint16_t mx = s[0];
   for(int16_t i = 0; i < OVER_N; i++)
-    Avg += Samples[i];
+  {
+    uint16_t v = s[i];
+    Avg += v;
+    Avg2 += (uint32_t)v * v;
+    if(v < mn) mn = v;
+    if(v > mx) mx = v;
+  }
+  Sum = Avg;
+  Sum2 = Avg2;
+  Block = s;
+  Min = mn << (ADC_RES - ADC_NR);
+  Max = mx << (ADC_RES - ADC_NR);
+#if ADC_CIRC
+#if ADC_IRQ
+  if(AdcN == 1) // ,   
+  {
+    //    , DMA   :
+    if((uint8_t)(Done - ++Taken)) Overrun++;
+  }
+  else
+#endif
+  {
+    // ,  ,  ,  :
+    uint32_t f = AdcN? (Half? DMA_ISR_TCIF7 : DMA_ISR_HTIF7) :
+                       (Half? DMA_ISR_TCIF5 : DMA_ISR_HTIF5);
+    uint32_t n = AdcN? (Half? DMA_ISR_HTIF7 : DMA_ISR_TCIF7) :
+                       (Half? DMA_ISR_HTIF5 : DMA_ISR_TCIF5);
+    DMA1->IFCR = f;                   //flag clear (IFCR = ISR bits)
+    //    , DMA   :
+    if(DMA1->ISR & n)
+    {
+      Overrun++;
+      //DMA    ,      :
+      uint16_t c = AdcN? DMA1_Channel7->CNDTR : DMA1_Channel5->CNDTR;
+      if((c > OVER_N) == Half) DMA1->IFCR = n;
+    }
+  }
+  Half = !Half;
+#else
   if(AdcN == 0) // ,   
   {
     DMA1_Channel5->CCR &= ~DMA_CCR5_EN; //DMA disable
@@ -205,6 +348,7 @@ inline TOverAdc<AdcN, AdcCh>::operator uint16_t()
     DMA1->IFCR = DMA_IFCR_CTCIF7;       //flag clear
     DMA1_Channel7->CCR |= DMA_CCR7_EN;  //DMA enable
   }
+#endif
   return((Avg * (1 << (ADC_RES - ADC_NR)) + OVER_N / 2) / OVER_N);
 }
 
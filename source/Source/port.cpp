@@ -9,6 +9,7 @@
 #include "display.h"
 #include "analog.h"
 #include "fan.h"
+#include "sched.h"
 
 //----------------------------------------------------------------------------
 //------------------------------  TPort ---------------------------------
@@ -19,12 +20,46 @@
 TPort::TPort(void)
 {
   WakePort = new TWakePort(BAUD_RATE, FRAME_SIZE);
+#if LOG_ENABLE
+  Logger = new TLogger();
+#endif
+}
+
+//-------------------------   : ----------------------------
+
+char TPort::GetStatus(void)
+{
+  char state, s = 0;
+  if(Analog->OutState()) s |= 0x01;
+  state = Analog->GetCvCcSt();
+  if(state & PS_CV) s |= 0x02;
+  if(state & PS_CC) s |= 0x04;
+  state = Analog->GetProtSt();
+  if(state & PR_OVP) s |= 0x08;
+  if(state & PR_OCP) s |= 0x10;
+  if(state & PR_OPP) s |= 0x20;
+  if(state & PR_OTP) s |= 0x40;
+  if(state & PR_I2T) s |= 0x80;
+  return(s);
 }
 
 //--------------------------  : ------------------------------
 
 void TPort::Execute(void)
 {
+#if LOG_ENABLE
+  // :
+  if(Logger->Due())
+  {
+    LogRec_t r;
+    r.V = Analog->AdcV->CodeToValue(Analog->AdcV->Code);
+    r.I = Analog->AdcI->CodeToValue(Analog->AdcI->Code);
+    r.P = (uint32_t)r.V * r.I / VI2P;
+    r.T = Analog->GetTemp();
+    r.S = GetStatus();
+    Logger->Add(r);
+  }
+#endif
   char Command = WakePort->GetCmd(); //   
   if(Command != CMD_NOP)             //  , 
   {
@@ -81,17 +116,7 @@ void TPort::Execute(void)
     case CMD_GET_STAT:
       {
         WakePort->AddByte(ERR_NO);
-        char state, s = 0;
-        if(Analog->OutState()) s |= 0x01;
-        state = Analog->GetCvCcSt();
-        if(state & PS_CV) s |= 0x02;
-        if(state & PS_CC) s |= 0x04;
-        state = Analog->GetProtSt();
-        if(state & PR_OVP) s |= 0x08;
-        if(state & PR_OCP) s |= 0x10;
-        if(state & PR_OPP) s |= 0x20;
-        if(state & PR_OTP) s |= 0x40;
-        WakePort->AddByte(s);
+        WakePort->AddByte(GetStatus());
         break;
       }
     //     
@@ -232,8 +257,10 @@ void TPort::Execute(void)
         uint16_t ci = WakePort->GetWord();
         if(cv > DACM) cv = DACM;
         if(ci > DACM) ci = DACM;
+        Analog->DacV->Hold(1);
         Analog->DacV->SetCode(cv);
         Analog->DacI->SetCode(ci);
+        Analog->DacV->Hold(0);
         WakePort->AddByte(ERR_NO);
         break;
       }
@@ -243,6 +270,7 @@ void TPort::Execute(void)
         WakePort->AddByte(ERR_NO);
         WakePort->AddWord(Analog->AdcV->Code);
         WakePort->AddWord(Analog->AdcI->Code);
+        WakePort->AddWord(Analog->AdcI->GetOffset());
         break;
       }
     //  
@@ -281,6 +309,300 @@ void TPort::Execute(void)
         }
         break;
       }
+    //   
+    case CMD_GET_AWD:
+      {
+#if AWD_PROT
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddWord(Analog->AwdTrips);
+        WakePort->AddWord((uint32_t)Analog->AwdLatency * 10 /
+                          (SYSTEM_CORE_CLOCK / 1000000));
+        WakePort->AddWord((uint32_t)Analog->AwdLatencyMax * 10 /
+                          (SYSTEM_CORE_CLOCK / 1000000));
+#else
+        WakePort->AddByte(ERR_PA);
+#endif
+        break;
+      }
+    //    
+    case CMD_GET_RPL:
+      {
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddWord(Analog->AdcV->RplRms);
+        WakePort->AddWord(Analog->AdcV->RplPp);
+        WakePort->AddWord(Analog->AdcI->RplRms);
+        WakePort->AddWord(Analog->AdcI->RplPp);
+        break;
+      }
+#if CAP_ENABLE
+    //  
+    case CMD_SET_CAP:
+      {
+        char m = WakePort->GetByte();
+        uint8_t d = WakePort->GetByte();
+        uint16_t l = WakePort->GetWord();
+        uint16_t n = WakePort->GetWord();
+        if(m >= CAP_MODES || n >= CAP_SIZE)
+        {
+          WakePort->AddByte(ERR_PA);
+          break;
+        }
+        //     ADC_NR:
+        if(m == CAP_VR || m == CAP_VF)
+          l = Analog->AdcV->ValueToCode(l) >> (ADC_RES - ADC_NR);
+        if(m == CAP_IR || m == CAP_IF)
+          l = Analog->AdcI->ValueToCode(l) >> (ADC_RES - ADC_NR);
+        Analog->Capture->Arm(m, d, l, n);
+        WakePort->AddByte(ERR_NO);
+        break;
+      }
+    //  
+    case CMD_GET_CAP:
+      {
+        uint8_t p = WakePort->GetByte();
+        TCapture *c = Analog->Capture;
+        if(p >= CAP_PAGES)
+        {
+          WakePort->AddByte(ERR_PA);
+          break;
+        }
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddByte(c->State);
+        WakePort->AddWord(c->TrigPos);
+        if(c->State == CST_DONE)
+        {
+          for(uint16_t k = p * CAP_PAGE; k < (p + 1) * CAP_PAGE; k++)
+          {
+            const uint8_t *d = c->Pair(k);
+            for(char j = 0; j < CAP_BYTES; j++)
+              WakePort->AddByte(d[j]);
+          }
+        }
+        break;
+      }
+#endif
+#if LOG_ENABLE
+    //  
+    case CMD_SET_LOG:
+      {
+        Logger->Start(WakePort->GetWord());
+        WakePort->AddByte(ERR_NO);
+        break;
+      }
+    //   
+    case CMD_GET_LOG:
+      {
+        LogRead(WakePort->GetDWord());
+        break;
+      }
+#endif
+    //    
+    case CMD_GET_EN:
+      {
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddDWord((uint64_t)Analog->EnergyTime * OVER_N * 1000 /
+                           ADC_FS);
+        WakePort->AddDWord(Analog->GetCharge());
+        WakePort->AddDWord(Analog->GetEnergy());
+        break;
+      }
+#if BENCH_ENABLE
+    //   
+    case CMD_GET_BENCH:
+      {
+        uint8_t n = WakePort->GetByte();
+        bool ok = n < BEN_OPS && !Analog->OutState();
+        WakePort->AddByte(ok? ERR_NO : ERR_PA);
+        WakePort->AddByte(BEN_OPS);
+        if(ok) WakePort->AddWord(Analog->Bench(n));
+        break;
+      }
+#endif
+    //   
+    case CMD_SET_CORR:
+      {
+        char ch = WakePort->GetByte();
+        if(ch >= CORR_CH || WakePort->GetRxCount() < CORR_PTS + 1)
+        {
+          WakePort->AddByte(ERR_PA);
+          break;
+        }
+        int8_t p[CORR_PTS];
+        for(char i = 0; i < CORR_PTS; i++)
+          p[i] = WakePort->GetByte();
+        Analog->Scaler(ch)->SetCorr(p);
+        Analog->SaveCorr(ch);
+        Analog->ProtChanged(); //  
+        Data->SetVI(); //  
+        WakePort->AddByte(ERR_NO);
+        break;
+      }
+    //   
+    case CMD_GET_CORR:
+      {
+        char ch = WakePort->GetByte();
+        if(ch >= CORR_CH)
+        {
+          WakePort->AddByte(ERR_PA);
+          break;
+        }
+        WakePort->AddByte(ERR_NO);
+        for(char i = 0; i < CORR_PTS; i++)
+          WakePort->AddByte(Analog->Scaler(ch)->GetCorr(i));
+        break;
+      }
+#if SEQ_ENABLE
+    //  
+    case CMD_SET_SEQ:
+      {
+        TSequencer *s = Analog->Sequencer;
+        uint8_t n = WakePort->GetByte();
+        if(n > SEQ_STEPS || WakePort->GetRxCount() < n * 6 + 3)
+        {
+          WakePort->AddByte(ERR_PA);
+          break;
+        }
+        s->Control(SQC_STOP);
+        s->Repeat = WakePort->GetWord();
+        for(char i = 0; i < n; i++)
+        {
+          s->Steps[i].V = WakePort->GetWord();
+          s->Steps[i].I = WakePort->GetWord();
+          s->Steps[i].Dwell = WakePort->GetWord();
+        }
+        s->Count = n;
+        s->Save();
+        WakePort->AddByte(ERR_NO);
+        break;
+      }
+    // 
+    case CMD_SEQ_RUN:
+      {
+        char m = WakePort->GetByte();
+        if(m >= SQC_CMDS)
+        {
+          WakePort->AddByte(ERR_PA);
+          break;
+        }
+        Analog->Sequencer->Control(m);
+        WakePort->AddByte(ERR_NO);
+        break;
+      }
+    //  
+    case CMD_GET_SEQ:
+      {
+        TSequencer *s = Analog->Sequencer;
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddByte(s->State);
+        WakePort->AddByte(s->Index);
+        WakePort->AddWord(s->Pass);
+        WakePort->AddByte(s->Count);
+        WakePort->AddWord(s->Repeat);
+        break;
+      }
+#endif
+#if CORR_SWEEP
+    //   
+    case CMD_CORR_SWEEP:
+      {
+        char m = WakePort->GetByte();
+        if(m > 3)
+        {
+          WakePort->AddByte(ERR_PA);
+          break;
+        }
+        if(m == 2) Analog->SweepStop();
+        if(m < 2 && !Analog->SweepStart(m))
+        {
+          WakePort->AddByte(ERR_RE);
+          break;
+        }
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddByte(Analog->SweepSt);
+        WakePort->AddByte(Analog->SweepPt);
+        break;
+      }
+#endif
+#if ACAL_ENABLE
+    //   
+    case CMD_SET_ACAL:
+      {
+        Analog->AcalPer = WakePort->GetWord();
+        Analog->AcalDT = WakePort->GetWord();
+        if(WakePort->GetByte()) Analog->AcalRequest();
+        WakePort->AddByte(ERR_NO);
+        break;
+      }
+    //   
+    case CMD_GET_ACAL:
+      {
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddWord(Analog->AcalCount);
+        WakePort->AddWord(Analog->AcalSkips);
+        WakePort->AddWord(Analog->AcalTime);
+        WakePort->AddWord(Analog->AcalTimeMax);
+        WakePort->AddByte(Analog->AcalFactor);
+        WakePort->AddByte(Analog->AcalDelta);
+        break;
+      }
+#endif
+    //   OVP/OCP
+    case CMD_GET_PROT:
+      {
+#if ADC_IRQ
+        WakePort->AddByte(ERR_NO);
+        WakePort->AddWord(Analog->ProtTrips);
+        WakePort->AddWord(Analog->GetProtSegs());
+        WakePort->AddWord((uint32_t)Analog->ProtLatency * 10 /
+                          (SYSTEM_CORE_CLOCK / 1000000));
+        WakePort->AddWord((uint32_t)Analog->ProtLatencyMax * 10 /
+                          (SYSTEM_CORE_CLOCK / 1000000));
+#else
+        WakePort->AddByte(ERR_PA);
+#endif
+        break;
+      }
+#if JRN_ENABLE
+    //   
+    case CMD_GET_JRN:
+      {
+        TJournal *j = Analog->Journal;
+        uint8_t n = WakePort->GetByte();
+        WakePort->AddByte((n < j->Count)? ERR_NO : ERR_PA);
+        WakePort->AddByte(j->Count);
+        WakePort->AddWord(j->Lost);
+        if(n >= j->Count) break;
+        WakePort->AddWord(j->Read(n, JW_SEQ));
+        WakePort->AddDWord(j->Read(n, JW_TLO) |
+                           (uint32_t)j->Read(n, JW_THI) << 16);
+        WakePort->AddByte(j->Read(n, JW_FLAG));
+        for(char w = JW_TEMP; w < JRN_WORDS; w++)
+          WakePort->AddWord(j->Read(n, w));
+        break;
+      }
+#endif
+#if SCH_ENABLE
+    //   
+    case CMD_GET_SCH:
+      {
+        uint8_t n = WakePort->GetByte();
+        if(n == 0xFF) Scheduler->Clear();
+        WakePort->AddByte((n < Scheduler->Count || n == 0xFF)?
+                          ERR_NO : ERR_PA);
+        WakePort->AddWord(Scheduler->Load);
+        WakePort->AddWord(Scheduler->LoadMax);
+        WakePort->AddByte(Scheduler->Count);
+        if(n >= Scheduler->Count) break;
+        TaskStat_t *t = &Scheduler->Stat[n];
+        WakePort->AddDWord(t->Runs);
+        WakePort->AddDWord((uint64_t)t->Time * 10 /
+                           (SYSTEM_CORE_CLOCK / 1000000));
+        WakePort->AddDWord((uint64_t)t->TimeMax * 10 /
+                           (SYSTEM_CORE_CLOCK / 1000000));
+        WakePort->AddWord(t->Missed);
+        break;
+      }
+#endif
     // 
     default: 
       {
@@ -291,4 +613,56 @@ void TPort::Execute(void)
   }
 }
 
+//-------------------   : ---------------------------
+
+#if LOG_ENABLE
+
+//n -   
+// ,       .
+
+void TPort::LogRead(uint32_t n)
+{
+  WakePort->AddByte(ERR_NO);
+  WakePort->AddWord(Logger->Interval);
+  WakePort->AddDWord(Logger->First);
+  WakePort->AddDWord(Logger->Count);
+  if(!Logger->Count)
+  {
+    WakePort->AddDWord(n);
+    WakePort->AddByte(0);
+    return;
+  }
+  LogRec_t r;
+  uint16_t pos;
+  n = Logger->Seek(n, r, pos);
+  WakePort->AddDWord(n);
+  //  ,   
+  //      :
+  int16_t free = FRAME_SIZE - WakePort->GetTxPtr() - 1 - LOG_REC_SIZE;
+  uint32_t last = Logger->First + Logger->Count;
+  LogRec_t t = r;
+  uint16_t end = pos;
+  char k = 1;
+  for(n++; n < last; n++)
+  {
+    uint16_t next = Logger->Next(end, t);
+    free -= (next > end)? next - end : next + LOG_SIZE - end;
+    if(free < 0) break;
+    end = next;
+    k++;
+  }
+  WakePort->AddByte(k);
+  WakePort->AddDWord(r.Time);
+  WakePort->AddWord(r.V);
+  WakePort->AddWord(r.I);
+  WakePort->AddWord(r.P);
+  WakePort->AddWord(r.T);
+  WakePort->AddByte(r.S);
+  uint16_t len = (end >= pos)? end - pos : end + LOG_SIZE - pos;
+  for(uint16_t j = 0; j < len; j++)
+    WakePort->AddByte(Logger->Byte(pos + j));
+}
+
+#endif
+
 //----------------------------------------------------------------------------
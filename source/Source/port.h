@@ -9,13 +9,14 @@
 
 #include "wakeport.h"
 #include "data.h"
+#include "logger.h"
 
 //----------------------------- : -----------------------------------
 
 #define BAUD_RATE       19200  // , 
-#define FRAME_SIZE         16  //  , 
+#define FRAME_SIZE         64  //  , 
 
-#define PAR_COUNT          23  // 
+#define PAR_COUNT          26  // 
 #define PAR_NON           255  //   
 
 //    CMD_SET_PAR  CMD_GET_PAR:
@@ -31,11 +32,11 @@ const uint8_t ParIdx[PAR_COUNT] =
   PAR_FNH,  //Fan full speed temperature
   PAR_TRC,  //Track (OFF/AUTOLOCK/ON)
   PAR_CON,  //Confirm (OFF/ON)
-  PAR_POW,  //Display power (OFF/ON)
+  PAR_POW,  //Display power (OFF/ON/ENERGY)
   PAR_SET,  //Display setpoint when regulated (OFF/ON)
   PAR_GET,  //Always display maesured values(OFF/ON)
-  PAR_APV,  //Display average/peak V (AVERAGE/PEAK HIGH/PEAK LOW)
-  PAR_APC,  //Display average/peak I (AVERAGE/PEAK HIGH/PEAK LOW)
+  PAR_APV,  //Display average/peak V (AVERAGE/PEAK HIGH/PEAK LOW/AVERAGE FAST/RIPPLE/ADAPTIVE)
+  PAR_APC,  //Display average/peak I (AVERAGE/PEAK HIGH/PEAK LOW/AVERAGE FAST/RIPPLE/ADAPTIVE)
   PAR_PRC,  //Current preview (OFF/ON)
   PAR_DNP,  //Down programmer (OFF/ON)
   PAR_OUT,  //Restore out state (OFF/ON)
@@ -43,7 +44,10 @@ const uint8_t ParIdx[PAR_COUNT] =
   PAR_ENR,  //Encoder reverse (OFF/ON)
   PAR_SPL,  //Splash screen (OFF/ON)
   PAR_INF,  //Firmware version info
-  PAR_TIM   //Timer interval
+  PAR_TIM,  //Timer interval
+  PAR_SRV,  //Soft-start V slew rate, x0.01 V/ms (VMAX - OFF)
+  PAR_SRI,  //Soft-start I slew rate, x0.001 A/ms (IMAX - OFF)
+  PAR_I2T   //OCP I2t budget, x0.01 A^2s (0 - instant OCP)
 };
 
 //----------------------------------------------------------------------------
@@ -53,8 +57,15 @@ const uint8_t ParIdx[PAR_COUNT] =
 class TPort
 {
 private:
+  char GetStatus(void);
+#if LOG_ENABLE
+  void LogRead(uint32_t n);
+#endif
 public:
   TWakePort *WakePort;
+#if LOG_ENABLE
+  TLogger *Logger;
+#endif
   TPort(void);
   void Execute(void);
 };
@@ -94,6 +105,7 @@ public:
   //S.4 = 1 - OCP
   //S.5 = 1 - OPP
   //S.6 = 1 - OTP
+  //S.7 = 1 - I2t
   //Err = ERR_NO
 
 #define CMD_GET_VI_AVG 9 //     
@@ -193,10 +205,11 @@ public:
 #define CMD_GET_ADC 19 //  
 
   //TX:
-  //RX: byte Err, word ADCV, word ADCI
+  //RX: byte Err, word ADCV, word ADCI, word OFSI
 
   //ADCV = 0..65520 -   
   //ADCI = 0..65520 -   
+  //OFSI -      (int16_t), 
   //Err = ERR_NO
 
 #define CMD_SET_CAL 20 //  
@@ -217,6 +230,260 @@ public:
   //K -   (.  )
   //Err = ERR_NO, ERR_PA
 
+#define CMD_GET_AWD 22 //   
+
+  //TX:
+  //RX: byte Err, word N, word L, word LM
+
+  //N -   analog watchdog
+  //L -    , x0.1 
+  //LM -   , x0.1 
+  //Err = ERR_NO, ERR_PA (   )
+
+#define CMD_GET_RPL 23 //    
+
+  //TX:
+  //RX: byte Err, word VR, word VP, word IR, word IP
+
+  //VR = 0..VMAX -   , x0.01 
+  //VP = 0..VMAX -   , x0.01 
+  //IR = 0..IMAX -   , x0.001 
+  //IP = 0..IMAX -   , x0.001 
+  //Err = ERR_NO
+
+#define CMD_SET_CAP 24 //  
+
+  //TX: byte M, byte D, word L, word N
+  //RX: byte Err
+
+  //M = 0..7 -   (OFF/NOW/V RISE/V FALL/I RISE/I FALL/
+  //           CV-CC/PROT)
+  //D = 1..255 - ,   D-  ( 10 )
+  //L -  , x0.01   M = 2, 3, x0.001   M = 4, 5
+  //N = 0..127 -     
+  //Err = ERR_NO, ERR_PA
+
+#define CMD_GET_CAP 25 //  
+
+  //TX: byte P
+  //RX: byte Err, byte S, word T, [48 bytes]
+
+  //P = 0..7 -   (16  )
+  //S = 0..3 -   (IDLE/ARMED/TRIG/DONE)
+  //T = 0..127 -  ,  
+  //     DONE,   - 3 :
+  //V[7:0], I[3:0]:V[11:8], I[11:4],   12 
+  //Err = ERR_NO, ERR_PA
+
+#define CMD_SET_LOG 26 //  
+
+  //TX: word T
+  //RX: byte Err
+
+  //T = 0..65535 -  ,  (0 -  )
+  //    .
+  //Err = ERR_NO, ERR_PA (  )
+
+#define CMD_GET_LOG 27 //   
+
+  //TX: dword N
+  //RX: byte Err, word T, dword F, dword C, dword N, byte K,
+  //    [dword TM, word V, word I, word P, word TP, byte S, packed data]
+
+  //T -  , 
+  //F -      
+  //C -    
+  //N -     ( ,
+  //      F..F + C - 1)
+  //K -   
+  // K > 0,    N   :
+  //TM -     , 
+  //V - , x0.01 , I - , x0.001 , P - , x0.1 
+  //TP - , x0.1C
+  //S -   (  CMD_GET_STAT)
+  // K - 1  .     ,
+  //    ,   ,   :
+  // 0 -  (varint,   0 ,   T),
+  // 1 -  S,  2..5 -  V, I, P, TP (zigzag varint).
+  //varint: 7   ,  ,  7 -  .
+  //zigzag: 0, -1, 1, -2, 2...   0, 1, 2, 3, 4...
+  //Err = ERR_NO, ERR_PA (  )
+
+#define CMD_GET_EN 28 //    
+
+  //TX:
+  //RX: byte Err, dword T, dword Q, dword E
+
+  //T -   (  ), 
+  //Q - , x0.001 
+  //E - , x0.1 
+  //    .
+  //Err = ERR_NO
+
+#define CMD_GET_BENCH 29 //   
+
+  //TX: byte N
+  //RX: byte Err, byte C, word T
+
+  //N -  : 0 - 64- , 1 - CodeToValue,
+  //    2 - ValueToCode, 3 - ValueToDac, 4 -   
+  //C -  
+  //T -   ,  CPU
+  // N >= C,   Err  C.
+  //Err = ERR_NO, ERR_PA (  ,   N
+  //  )
+
+#define CMD_SET_CORR 30 //   
+
+  //TX: byte C, byte D0, byte D1 ... byte D16
+  //RX: byte Err
+
+  //C = 0..3 -  (DAC V, DAC I, ADC V, ADC I)
+  //Dn = -128..127 -     n (int8_t),  
+  //     4096 (0, 4096 ... 65536),  16 .
+  // :   =   + ,  
+  // .  :   =   
+  // + .     .
+  //      EEPROM ( CORR_EEPROM,
+  //   ).
+  //Err = ERR_NO, ERR_PA
+
+#define CMD_GET_CORR 31 //   
+
+  //TX: byte C
+  //RX: byte Err, byte D0, byte D1 ... byte D16
+
+  //C = 0..3 -  (DAC V, DAC I, ADC V, ADC I)
+  //Dn = -128..127 -     n (int8_t)
+  //Err = ERR_NO, ERR_PA
+
+#define CMD_SET_SEQ 32 //  
+
+  //TX: byte N, word R, word V0, word I0, word T0 ... word Vn, word In,
+  //    word Tn
+  //RX: byte Err
+
+  //N = 0..8 -  
+  //R -   , 0 -  
+  //Vn -  , x0.01 
+  //In -  , x0.001 
+  //Tn = 1..65535 -  , 
+  //  ,     EEPROM
+  //( SEQ_EEPROM).
+  //Err = ERR_NO, ERR_PA
+
+#define CMD_SEQ_RUN 33 // 
+
+  //TX: byte M
+  //RX: byte Err
+
+  //M = 0..3 -  (STOP/START/ARM/TRIG)
+  //ARM -    TRIG, TRIG   
+  // -     .
+  //     ,  
+  // .
+  //Err = ERR_NO, ERR_PA (  )
+
+#define CMD_GET_SEQ 34 //  
+
+  //TX:
+  //RX: byte Err, byte S, byte N, word P, byte C, word R
+
+  //S = 0..2 -  (IDLE/ARMED/RUN)
+  //N -   
+  //P -   
+  //C -   
+  //R -   
+  //Err = ERR_NO, ERR_PA (  )
+
+#define CMD_CORR_SWEEP 35 //   
+
+  //TX: byte M
+  //RX: byte Err, byte S, byte N
+
+  //M = 0..3 -  (START DAC V/START DAC I/STOP/STATUS)
+  //S = 0..4 -  (IDLE/RUN/DONE/FAIL/RAM), DONE - 
+  //  EEPROM, RAM -  ,   
+  //(     EEPROM  CORR_EEPROM = 0)
+  //N -   
+  //    ,  DAC I   
+  //.     ,   CMD_SET_CORR,
+  //    CMD_GET_CORR.    0.56 .
+  //Err = ERR_NO, ERR_PA, ERR_RE (     )
+
+#define CMD_SET_ACAL 36 //   
+
+  //TX: word P, word T, byte N
+  //RX: byte Err
+
+  //P -  ,  (0 - )
+  //T -    , x0.1C (0 - )
+  //N = 1 -   
+  //    EEPROM.
+  //Err = ERR_NO, ERR_PA (  )
+
+#define CMD_GET_ACAL 37 //   
+
+  //TX:
+  //RX: byte Err, word C, word S, word T, word TM, byte F, byte D
+
+  //C -  
+  //S -    
+  //T -   ,  CPU
+  //TM -   ,  CPU
+  //F -   
+  //D -      (int8_t)
+  //Err = ERR_NO, ERR_PA (  )
+
+#define CMD_GET_PROT 38 //   OVP/OCP
+
+  //TX:
+  //RX: byte Err, word N, word B, word L, word LM
+
+  //N -      
+  //B -  ,  ( = 1  / PROT_BPM)
+  //L -       , x0.1 
+  //LM -   , x0.1 
+  //    : 1  + B  + LM
+  //(  1     B + 1  ).
+  //Err = ERR_NO, ERR_PA (    )
+
+#define CMD_GET_JRN 39 //   
+
+  //TX: byte N
+  //RX: byte Err, byte C, word L, word S, dword T, byte F, word Tmp,
+  //    word SV, word SI, JRN_N x word V, JRN_N x word I
+
+  //N -   (0 - )
+  //C -    
+  //L -  ,      EEPROM
+  //S -  
+  //T -    , 
+  //F -   (0x01 - OVP, 0x02 - OCP, 0x04 - OPP, 0x08 - OTP,
+  //    0x10 - I2t)
+  //Tmp - , x0.1C
+  //SV, SI -    
+  //V, I -    ,    
+  // N >= C,   Err, C  L.
+  //Err = ERR_NO, ERR_PA (      N)
+
+#define CMD_GET_SCH 40 //   
+
+  //TX: byte N
+  //RX: byte Err, word L, word LM, byte C, dword R, dword T, dword TM,
+  //    word M
+
+  //N -   (   main.cpp), 0xFF -  
+  //L -  CPU    SCH_WIN, x0.1%
+  //LM -   CPU, x0.1%
+  //C -  
+  //R -    N
+  //T -     N, x0.1 
+  //TM -     N, x0.1 
+  //M -     N
+  // N >= C,   Err, L, LM  C.
+  //Err = ERR_NO, ERR_PA (      N)
+
 //----------------------------------------------------------------------------
 
 #endif
@@ -0,0 +1,185 @@
+//----------------------------------------------------------------------------
+
+//  
+
+//-----------------------  : ------------------------------
+
+// TScheduler  ,      
+//    .   
+// Task_t: , , ,    .
+//       
+//  (TSysTimer::Tick),     Tick 
+//SecTick   .    
+// ,    (Post), , 
+//  .      
+// ,      .
+//     ,  
+//   (  Deadline   ).
+// CPU -       SCH_WIN .
+//   SysTick (TSysTimer::GetCycles).
+//   ,     (SCH_SLEEP).
+
+//----------------------------------------------------------------------------
+
+#include "main.h"
+#include "sched.h"
+
+//----------------------------------------------------------------------------
+//---------------------------  TScheduler: ------------------------------
+//----------------------------------------------------------------------------
+
+//----------------------------- : ---------------------------------
+
+TScheduler::TScheduler(const Task_t *tasks, uint8_t count)
+{
+  Tasks = tasks;
+  Count = count;
+  Stat = new TaskStat_t[Count];
+  uint32_t t = TSysTimer::GetCounter();
+  for(char k = 0; k < Count; k++)
+  {
+    Stat[k].Ready = 0;
+    Stat[k].Due = t + tasks[k].Period;
+  }
+  Clear();
+}
+
+//--------------------------  : -------------------------------
+
+void TScheduler::Clear(void)
+{
+  for(char k = 0; k < Count; k++)
+  {
+    Stat[k].Runs = 0;
+    Stat[k].Time = 0;
+    Stat[k].TimeMax = 0;
+    Stat[k].Missed = 0;
+  }
+  Busy = 0;
+  WinStart = TSysTimer::GetCycles();
+  WinMs = TSysTimer::GetCounter();
+  Load = 0;
+  LoadMax = 0;
+}
+
+//-------------------------  : ---------------------------------
+
+//  .
+
+volatile uint8_t TScheduler::Pending = SEV_NONE;
+
+void TScheduler::Post(uint8_t ev)
+{
+  Pending |= ev;
+}
+
+//----------------------    : -------------------------
+
+//ev -  , tick -    .
+//       .
+
+void TScheduler::Release(uint8_t ev, bool tick)
+{
+  uint32_t t = TSysTimer::GetCounter();
+  for(char k = 0; k < Count; k++)
+  {
+    TaskStat_t *s = &Stat[k];
+    bool r = Tasks[k].Events & ev;
+    uint32_t rt = t;
+    if(tick && Tasks[k].Period &&
+       (int32_t)(t - s->Due) >= 0)
+    {
+      //     :
+      r = 1;
+      rt = s->Due;
+      s->Due += Tasks[k].Period;
+      //   :
+      if((int32_t)(t - s->Due) >= 0) s->Due = t + Tasks[k].Period;
+    }
+    if(r && !s->Ready)
+    {
+      s->Ready = 1;
+      s->Release = rt;
+    }
+  }
+}
+
+//------------------------   : -----------------------------
+
+//        -1.
+//    ,    .
+
+int8_t TScheduler::Select(void)
+{
+  int8_t n = -1;
+  for(char k = 0; k < Count; k++)
+  {
+    if(Stat[k].Ready && (n < 0 || Tasks[k].Prio < Tasks[n].Prio))
+      n = k;
+  }
+  return(n);
+}
+
+//-------------------------  : -------------------------------
+
+void TScheduler::Run(uint8_t n)
+{
+  TaskStat_t *s = &Stat[n];
+  s->Ready = 0;
+  uint32_t c = TSysTimer::GetCycles();
+  Tasks[n].Func();
+  c = TSysTimer::GetCycles() - c;
+  s->Time = c;
+  if(c > s->TimeMax) s->TimeMax = c;
+  s->Runs++;
+  Busy += c;
+  if(TSysTimer::GetCounter() - s->Release >= Tasks[n].Deadline)
+    s->Missed++;
+}
+
+//------------------------   CPU: ------------------------------
+
+void TScheduler::LoadUpdate(void)
+{
+  if(TSysTimer::GetCounter() - WinMs < SCH_WIN) return;
+  uint32_t c = TSysTimer::GetCycles();
+  uint32_t w = c - WinStart;
+  Load = ((uint64_t)Busy * 1000 + w / 2) / w;
+  if(Load > LoadMax) LoadMax = Load;
+  Busy = 0;
+  WinStart = c;
+  WinMs = TSysTimer::GetCounter();
+}
+
+//---------------------   : ---------------------
+
+void TScheduler::Execute(void)
+{
+  uint32_t t = TSysTimer::GetCounter();
+  TSysTimer::Sync();
+  bool tick = TSysTimer::Tick;
+  int8_t n;
+  do
+  {
+    __disable_interrupt();
+    uint8_t ev = Pending;
+    Pending = SEV_NONE;
+    __enable_interrupt();
+    Release(ev, tick);
+    tick = 0; //      
+    n = Select();
+    if(n >= 0) Run(n);
+  }
+  while(n >= 0);
+  LoadUpdate();
+#if SCH_SLEEP
+  //COUNTFLAG  ,      Sync,
+  //       .
+  //,   ,  WFI:
+  __disable_interrupt();
+  if(!Pending && TSysTimer::GetCounter() == t) __WFI();
+  __enable_interrupt();
+#endif
+}
+
+//----------------------------------------------------------------------------
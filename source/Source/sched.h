@@ -0,0 +1,87 @@
+//----------------------------------------------------------------------------
+
+//  ,  
+
+//----------------------------------------------------------------------------
+
+#ifndef SCHED_H
+#define SCHED_H
+
+//----------------------------------------------------------------------------
+
+#include "systimer.h"
+
+//----------------------------- : -----------------------------------
+
+#define SCH_ENABLE    1 // on/off (off - )
+#define SCH_SLEEP     1 //  (WFI)    
+#define SCH_WIN    1000 //   CPU, 
+
+//,     :
+
+enum SchEvent_t
+{
+  SEV_NONE = 0x00, // 
+  SEV_ADC  = 0x01  //   ( DMA  V)
+};
+
+// :
+
+typedef void (*TaskFunc_t)(void);
+
+typedef struct
+{
+  TaskFunc_t Func;   // 
+  uint8_t Prio;      // (0 - )
+  uint16_t Period;   // ,  (0 -   )
+  uint16_t Deadline; //     , 
+  uint8_t Events;    //  SchEvent_t
+} Task_t;
+
+//   :
+
+typedef struct
+{
+  bool Ready;        //   
+  uint32_t Due;      //   , 
+  uint32_t Release;  //    , 
+  uint32_t Runs;     // 
+  uint32_t Time;     //  ,  CPU
+  uint32_t TimeMax;  //  ,  CPU
+  uint16_t Missed;   //  
+} TaskStat_t;
+
+//----------------------------------------------------------------------------
+//---------------------------  TScheduler: ------------------------------
+//----------------------------------------------------------------------------
+
+class TScheduler
+{
+private:
+  const Task_t *Tasks;
+  static volatile uint8_t Pending;
+  uint32_t Busy;     //    ,  CPU
+  uint32_t WinStart; // ,  CPU
+  uint32_t WinMs;    // , 
+  void Release(uint8_t ev, bool tick);
+  int8_t Select(void);
+  void Run(uint8_t n);
+  void LoadUpdate(void);
+public:
+  TScheduler(const Task_t *tasks, uint8_t count);
+  uint8_t Count;       // 
+  TaskStat_t *Stat;
+  uint16_t Load;       // CPU, x0.1%
+  uint16_t LoadMax;    //  CPU, x0.1%
+  static void Post(uint8_t ev);
+  void Execute(void);
+  void Clear(void);
+};
+
+//----------------------------------------------------------------------------
+
+extern TScheduler *Scheduler;
+
+//----------------------------------------------------------------------------
+
+#endif
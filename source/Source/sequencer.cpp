@@ -0,0 +1,189 @@
+//----------------------------------------------------------------------------
+
+//  
+
+//-----------------------  : ------------------------------
+
+// TSequencer    (V, I, )  
+// .     
+//RAMP_TIM (RAMP_FS = 5 , 5   1 ),  
+//      .   
+// DacV  DacI  SetValue(),   soft-start  
+//MAXV/MAXI.        
+// PAR_V  PAR_I.    .
+// SEQ_EEPROM    EEPROM ( TCrcSection)
+//   .
+// RAM: SEQ_STEPS * 6 + 16 .
+
+//----------------------------------------------------------------------------
+
+#include "main.h"
+#include "sequencer.h"
+#include "analog.h"
+#include "data.h"
+
+//----------------------------------------------------------------------------
+//---------------------------  TSequencer: ------------------------------
+//----------------------------------------------------------------------------
+
+//----------------------------- : ---------------------------------
+
+TSequencer::TSequencer(void)
+{
+#if SEQ_EEPROM
+  EeSection = 0;
+#endif
+  Count = 0;
+  Repeat = 0;
+  State = SQS_IDLE;
+  Index = 0;
+  Pass = 0;
+  Ticks = 0;
+}
+
+//------------------------    EEPROM: --------------------------
+
+//   EEPROM   .
+//   EEPROM   .
+
+void TSequencer::InitEeprom(void)
+{
+#if SEQ_EEPROM
+  uint8_t e = TEeprom::Error;
+  EeSection = new TCrcSection(SEQ_WORDS);
+  if(!EeSection->Valid)
+  {
+    if(TEeprom::Error & ER_ALLOC) EeSection = 0;
+    TEeprom::Error = e | (TEeprom::Error & ER_ALLOC);
+    return;
+  }
+  Count = EeSection->Read(0);
+  Repeat = EeSection->Read(1);
+  if(Count > SEQ_STEPS) Count = 0;
+  for(char i = 0; i < SEQ_STEPS; i++)
+  {
+    Steps[i].V = EeSection->Read(i * 3 + 2);
+    Steps[i].I = EeSection->Read(i * 3 + 3);
+    Steps[i].Dwell = EeSection->Read(i * 3 + 4);
+  }
+#endif
+}
+
+//------------------------    EEPROM: -----------------------
+
+void TSequencer::Save(void)
+{
+#if SEQ_EEPROM
+  if(!EeSection) return;
+  EeSection->Update(0, Count);
+  EeSection->Update(1, Repeat);
+  for(char i = 0; i < SEQ_STEPS; i++)
+  {
+    bool u = i < Count;
+    EeSection->Update(i * 3 + 2, u? Steps[i].V : 0);
+    EeSection->Update(i * 3 + 3, u? Steps[i].I : 0);
+    EeSection->Update(i * 3 + 4, u? Steps[i].Dwell : 0);
+  }
+  EeSection->Validate();
+#endif
+}
+
+//----------------------------- : ----------------------------------
+
+//cmd -  SeqCmd_t ( ).
+
+void TSequencer::Control(char cmd)
+{
+  switch(cmd)
+  {
+  case SQC_STOP:
+    Stop();
+    break;
+  case SQC_START:
+    Stop();
+    Run();
+    break;
+  case SQC_ARM:
+    Stop();
+    if(Count) State = SQS_ARMED;
+    break;
+  case SQC_TRIG:
+    if(State == SQS_ARMED) Run();
+      else if(State == SQS_RUN) Ticks = 1; //   
+    break;
+  }
+}
+
+//-----------------------------  : ------------------------------
+
+//    RAMP_TIM.
+
+void TSequencer::Stop(void)
+{
+  bool run = (State == SQS_RUN);
+  State = SQS_IDLE;
+  if(run) Restore();
+}
+
+//----------------------------  : ------------------------------
+
+//   RAMP_TIM,  true,   .
+
+bool TSequencer::Tick(void)
+{
+  if(State != SQS_RUN) return(0);
+  if(--Ticks) return(1);
+  if(++Index >= Count)
+  {
+    Index = 0;
+    if(Repeat && ++Pass >= Repeat)
+    {
+      Stop();
+      return(0);
+    }
+  }
+  Load(Index);
+  return(1);
+}
+
+//-----------------------------  : -------------------------------
+
+void TSequencer::Run(void)
+{
+  if(!Count) return;
+  Index = 0;
+  Pass = 0;
+  Load(0);
+  State = SQS_RUN;
+  RAMP_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+//----------------------------   n: ------------------------------
+
+void TSequencer::Load(uint8_t n)
+{
+  uint16_t v = Steps[n].V;
+  uint16_t i = Steps[n].I;
+  if(v > Data->MainData->Items[PAR_V]->Max)
+    v = Data->MainData->Items[PAR_V]->Max;
+  if(i > Data->MainData->Items[PAR_I]->Max)
+    i = Data->MainData->Items[PAR_I]->Max;
+  Analog->DacV->Hold(1); //V  I    
+  Analog->DacV->SetValue(v);
+  Analog->DacI->SetValue(i);
+  Analog->DacV->Hold(0);
+  uint16_t d = Steps[n].Dwell? Steps[n].Dwell : 1;
+  Ticks = (uint32_t)d * (RAMP_FS / 1000);
+}
+
+//-------------------------  : --------------------------
+
+void TSequencer::Restore(void)
+{
+  Analog->DacV->Hold(1);
+  Analog->DacV->SetValue(Data->MainData->Items[PAR_V]->Value);
+  Analog->DacI->SetValue(Data->MainData->Items[PAR_I]->Value);
+  Analog->DacV->Hold(0);
+}
+
+//----------------------------------------------------------------------------
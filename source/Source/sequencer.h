@@ -0,0 +1,86 @@
+//----------------------------------------------------------------------------
+
+//  ,  
+
+//----------------------------------------------------------------------------
+
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+//----------------------------------------------------------------------------
+
+#include "eeprom.h"
+
+//----------------------------- : -----------------------------------
+
+#define SEQ_ENABLE    1 // on/off
+#define SEQ_STEPS     8 //   
+#define SEQ_WORDS (SEQ_STEPS * 3 + 2) //  EEPROM, 
+
+//   SEQ_WORDS + 2 = 28  EEPROM (. data.h).
+// SEQ_EEPROM     RAM    ,
+//     V (RING_V).
+
+#define SEQ_EEPROM    1 //   EEPROM on/off
+
+// :
+
+typedef struct
+{
+  uint16_t V;     //, x0.01 
+  uint16_t I;     //, x0.001 
+  uint16_t Dwell; // , 
+} SeqStep_t;
+
+// :
+
+enum SeqCmd_t
+{
+  SQC_STOP,  //
+  SQC_START, // 
+  SQC_ARM,   //  SQC_TRIG
+  SQC_TRIG,  //     
+  SQC_CMDS
+};
+
+// :
+
+enum SeqState_t
+{
+  SQS_IDLE,  //  
+  SQS_ARMED, // 
+  SQS_RUN    // 
+};
+
+//----------------------------------------------------------------------------
+//---------------------------  TSequencer: ------------------------------
+//----------------------------------------------------------------------------
+
+class TSequencer
+{
+private:
+#if SEQ_EEPROM
+  TCrcSection *EeSection;
+#endif
+  volatile uint32_t Ticks; //  ,  RAMP_FS
+  void Load(uint8_t n);
+  void Restore(void);
+  void Run(void);
+public:
+  TSequencer(void);
+  SeqStep_t Steps[SEQ_STEPS];
+  uint8_t Count;           // 
+  uint16_t Repeat;         // , 0 -  
+  volatile char State;
+  volatile uint8_t Index;  //  
+  volatile uint16_t Pass;  //  
+  void InitEeprom(void);
+  void Save(void);
+  void Control(char cmd);
+  void Stop(void);
+  bool Tick(void);
+};
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -74,6 +74,35 @@ void SysTick_Handler(void)
   TSysTimer::Counter++;
 }
 
+//-----------------------    : -------------------------
+
+//      (  49.7 ).
+
+uint32_t TSysTimer::GetCounter(void)
+{
+  return(Counter);
+}
+
+//----------------------     CPU: ------------------------
+
+//      CPU (  179 ).
+// SysTick  ,     ,
+//     PENDSTSET.
+
+uint32_t TSysTimer::GetCycles(void)
+{
+  uint32_t ms, v, p;
+  do
+  {
+    ms = Counter;
+    v = SysTick->VAL;
+    p = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+  }
+  while(ms != Counter);
+  if(p && v > CLK_PER_MS / 2) ms++;
+  return(ms * CLK_PER_MS + CLK_PER_MS - 1 - v);
+}
+
 //-----------------------   : --------------------------
 
 #ifdef USE_SEC  
@@ -47,6 +47,8 @@ public:
   static void SecReset(void);
 #endif  
   static void Sync(void);
+  static uint32_t GetCounter(void);
+  static uint32_t GetCycles(void);
   static void Delay_us(uint16_t d);
   static void Delay_ms(uint32_t d);
   static void TimeoutStart_us(uint16_t t);
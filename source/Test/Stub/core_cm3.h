@@ -0,0 +1,70 @@
+//----------------------------------------------------------------------------
+
+// core_cm3.h    IAR    
+
+//----------------------------------------------------------------------------
+
+#ifndef CORE_CM3_H
+#define CORE_CM3_H
+
+//----------------------------------------------------------------------------
+
+#include <stdint.h>
+
+#define __I  volatile const
+#define __O  volatile
+#define __IO volatile
+
+typedef struct
+{
+  __IO uint32_t CTRL;
+  __IO uint32_t LOAD;
+  __IO uint32_t VAL;
+  __I  uint32_t CALIB;
+} SysTick_Type;
+
+typedef struct
+{
+  __I  uint32_t CPUID;
+  __IO uint32_t ICSR;
+  __IO uint32_t VTOR;
+  __IO uint32_t AIRCR;
+  __IO uint32_t SCR;
+  __IO uint32_t CCR;
+} SCB_Type;
+
+#define SysTick ((SysTick_Type *)0xE000E010)
+#define SCB     ((SCB_Type *)0xE000ED00)
+
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL << 16)
+#define SCB_ICSR_PENDSTSET_Msk     (1UL << 26)
+
+static inline void NVIC_EnableIRQ(IRQn_Type) {}
+static inline void NVIC_DisableIRQ(IRQn_Type) {}
+static inline void NVIC_SetPriority(IRQn_Type, uint32_t) {}
+static inline void NVIC_SystemReset(void) {}
+static inline uint32_t SysTick_Config(uint32_t) { return(0); }
+
+//  IAR,   (PRIMASK)  .
+//,    ,   
+// HostIrq   ( ,     ):
+
+typedef uint32_t __istate_t;
+
+static __istate_t HostPrimask = 0;
+static void (*HostIrq)(void) = 0;
+
+static inline void __disable_interrupt(void)
+{
+  if(HostIrq && !HostPrimask) HostIrq();
+  HostPrimask = 1;
+}
+
+static inline void __enable_interrupt(void) { HostPrimask = 0; }
+static inline __istate_t __get_interrupt_state(void) { return(HostPrimask); }
+static inline void __set_interrupt_state(__istate_t s) { HostPrimask = s; }
+static inline void __WFI(void) {}
+
+//----------------------------------------------------------------------------
+
+#endif
@@ -0,0 +1,288 @@
+//----------------------------------------------------------------------------
+
+//   TOverAdc   ADC_CIRC:   
+//    ,   , 
+//     Overrun
+
+//----------------------------------------------------------------------------
+
+// DMA  :     
+//, DMA  5 ( 0)  7 ( 1)    
+//UNITS ,   HTIF/TCIF   CNDTR.
+//   7     DMA1_Channel7
+//(    ):    Done++.
+// 0    ,  1 -  Done  Taken.
+// -    ,   
+//,     ,     
+//   .     
+//, Overrun   .    
+//    :   
+//    Overrun,  
+//   .   1 Overrun   
+//   .
+
+#include "main.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+//----------------------------- : -----------------------------------
+
+#define READS  200000 //   
+#define UNITS       4 //     
+#define FAST   (OVER_N * UNITS / 2) //   
+#define SLOW   (OVER_N * UNITS * 5) //  
+
+//--------------------------   DMA: ---------------------------
+
+static void Tick(void);
+static void Written(void);
+
+struct TReg
+{
+  uint32_t V;
+  operator uint32_t() { Tick(); return(V); }
+  TReg &operator = (uint32_t v) { Tick(); V = v; Written(); return(*this); }
+};
+
+struct THostChannel { TReg CCR, CNDTR, CPAR, CMAR; };
+struct THostDma { TReg ISR, IFCR; };
+
+static THostDma Dma;
+static THostChannel Ch5, Ch7;
+
+#undef DMA1
+#undef DMA1_Channel5
+#undef DMA1_Channel7
+#define DMA1 (&Dma)
+#define DMA1_Channel5 (&Ch5)
+#define DMA1_Channel7 (&Ch7)
+
+#define private public //   , Half  Taken
+#include "overadc.h"
+#undef private
+
+//----------------------------- : ----------------------------------
+
+static TOverAdc<0, PIN6> Adc0;
+static TOverAdc<1, PIN7> Adc1;
+
+//  DMA :
+
+struct TChan
+{
+  THostChannel *Ch;
+  uint16_t *Samples;
+  uint32_t Ht, Tc;            //   DMA1->ISR
+  uint16_t Pos;               //    
+  uint32_t Idx[ADC_BUFF];     //   
+  uint16_t Copy[ADC_BUFF];    //   
+  uint32_t Seen[ADC_BUFF];    //    
+  int32_t Last;               //   
+  bool Counted;               //    Overrun
+  uint32_t Reads, Lost;
+};
+
+static TChan Chan[2];
+static uint32_t Count;        //  
+static uint32_t Now;          //,   
+static bool IrqPending;       //  7  
+static bool InIsr;
+static uint32_t Errors;
+
+//--------------------------  : -------------------------------
+
+static uint16_t Gen(uint32_t i, char n)
+{
+  return(((i + n * 7777) * 2654435761u >> 16) & ((1 << ADC_NR) - 1));
+}
+
+//------------------------------ : -------------------------------------
+
+static void Error(char n, const char *s)
+{
+  if(Errors++ < 10) printf("ADC %d, read %u: %s\n", n, Chan[n].Reads, s);
+}
+
+//--------------------------   DMA: -----------------------------
+
+static void Transfer(TChan &c)
+{
+  c.Samples[c.Pos] = Gen(Count, &c - Chan);
+  c.Idx[c.Pos] = Count;
+  if(++c.Pos == OVER_N) Dma.ISR.V |= c.Ht;
+  if(c.Pos == ADC_BUFF)
+  {
+    c.Pos = 0; // 
+    Dma.ISR.V |= c.Tc;
+  }
+  c.Ch->CNDTR.V = ADC_BUFF - c.Pos;
+}
+
+//------------------     : ------------------
+
+static void Tick(void)
+{
+  if(++Now % UNITS == 0)
+  {
+    Transfer(Chan[0]); //CC1  CC2
+    Transfer(Chan[1]);
+    Count++;
+    if(Dma.ISR.V & (DMA_ISR_HTIF7 | DMA_ISR_TCIF7)) IrqPending = 1;
+  }
+  if(InIsr || !IrqPending) return;
+  // DMA1_Channel7_IRQHandler:
+  InIsr = 1;
+  IrqPending = 0;
+  uint32_t f = DMA1->ISR & (DMA_ISR_HTIF7 | DMA_ISR_TCIF7);
+  DMA1->IFCR = f | DMA_IFCR_CGIF7;
+  if(f & DMA_ISR_HTIF7) TOverAdc<1, PIN7>::Done++;
+  if(f & DMA_ISR_TCIF7) TOverAdc<1, PIN7>::Done++;
+  InIsr = 0;
+}
+
+//-------------------------  : --------------------------------
+
+static void Written(void)
+{
+  if(Dma.IFCR.V)
+  {
+    Dma.ISR.V &= ~Dma.IFCR.V;
+    Dma.IFCR.V = 0;
+  }
+}
+
+//---------------------------  : --------------------------------
+
+// ,         .
+//   ,   :  
+//   ,     .  
+//     :     
+// ,       .
+
+template<uint8_t AdcN, uint8_t AdcPin>
+static void Check(TOverAdc<AdcN, AdcPin> &a, uint16_t v, uint32_t ov)
+{
+  TChan &c = Chan[AdcN];
+  uint16_t p = a.Block - c.Samples;
+  if(p != 0 && p != OVER_N) { Error(AdcN, "wrong block pointer"); return; }
+  const uint16_t *s = &c.Copy[p];
+  uint32_t sum = 0, sum2 = 0;
+  uint16_t mn = s[0], mx = s[0];
+  bool whole = 1;
+  for(uint16_t i = 0; i < OVER_N; i++)
+  {
+    if(s[i] != Gen(c.Seen[p + i], AdcN)) Error(AdcN, "sample mismatch");
+    if(c.Seen[p + i] != c.Seen[p] + i) whole = 0;
+    sum += s[i];
+    sum2 += (uint32_t)s[i] * s[i];
+    if(s[i] < mn) mn = s[i];
+    if(s[i] > mx) mx = s[i];
+  }
+  if(a.Sum != sum || a.Sum2 != sum2) Error(AdcN, "wrong sums");
+  if(a.Min != mn << (ADC_RES - ADC_NR) || a.Max != mx << (ADC_RES - ADC_NR))
+    Error(AdcN, "wrong min/max");
+  if(v != (sum * (1 << (ADC_RES - ADC_NR)) + OVER_N / 2) / OVER_N)
+    Error(AdcN, "wrong code");
+  ov = a.Overrun - ov;
+  c.Reads++;
+  if(!whole)
+  {
+    if(!ov) Error(AdcN, "overwritten block is not counted");
+    c.Counted = 1;
+    return;
+  }
+  int32_t n = c.Seen[p] / OVER_N;
+  if(n <= c.Last) Error(AdcN, "block is read twice");
+  else if(n != c.Last + 1)
+  {
+    c.Lost += n - c.Last - 1;
+    if(!ov && !c.Counted) Error(AdcN, "missed half is not counted");
+  }
+  c.Counted = 0;
+  //  Done ,     :
+  if(AdcN == 1 && ov != (uint32_t)(n - c.Last - 1))
+    Error(AdcN, "wrong overrun count");
+  c.Last = n;
+}
+
+//--------------------------   : -------------------------------
+
+template<uint8_t AdcN, uint8_t AdcPin>
+static void Read(TOverAdc<AdcN, AdcPin> &a)
+{
+  if(!a.Ready()) return;
+  TChan &c = Chan[AdcN];
+  memcpy(c.Copy, c.Samples, sizeof(c.Copy));
+  memcpy(c.Seen, c.Idx, sizeof(c.Seen));
+  uint32_t ov = a.Overrun;
+  uint16_t v = a;
+  Check(a, v, ov);
+}
+
+//-------------------------   : -------------------------------
+
+static void Run(bool late)
+{
+  Count = 0;
+  Dma.ISR.V = 0;
+  IrqPending = 0;
+  for(char n = 0; n < 2; n++)
+  {
+    TChan &c = Chan[n];
+    c.Ch = n? &Ch7 : &Ch5;
+    c.Samples = n? Adc1.Samples : Adc0.Samples;
+    c.Ht = n? DMA_ISR_HTIF7 : DMA_ISR_HTIF5;
+    c.Tc = n? DMA_ISR_TCIF7 : DMA_ISR_TCIF5;
+    c.Pos = 0;
+    c.Ch->CNDTR.V = ADC_BUFF;
+    for(uint16_t i = 0; i < ADC_BUFF; i++)
+    {
+      c.Idx[i] = UINT32_MAX - 2 * i; //   
+      c.Samples[i] = Gen(c.Idx[i], n);
+    }
+    c.Last = -1;
+    c.Counted = 0;
+    c.Reads = c.Lost = 0;
+  }
+  //  Init:
+  Adc0.Half = Adc1.Half = 0;
+  Adc1.Taken = TOverAdc<1, PIN7>::Done;
+  Adc0.Overrun = Adc1.Overrun = 0;
+  for(uint32_t k = 0; k < READS; k++)
+  {
+    uint32_t t = late && rand() % 16 == 0? SLOW : FAST;
+    for(uint32_t i = rand() % t; i; i--) Tick();
+    //       :
+    if(rand() % 2) { Read(Adc0); Read(Adc1); }
+    else { Read(Adc1); Read(Adc0); }
+  }
+  uint32_t h = Count / OVER_N;
+  for(char n = 0; n < 2; n++)
+  {
+    TChan &c = Chan[n];
+    uint32_t ov = n? Adc1.Overrun : Adc0.Overrun;
+    if(!late && ov) Error(n, "overrun without delay");
+    //  , ,  , :
+    if(c.Reads + c.Lost + 1 < h) Error(n, "blocks are not read");
+    if(late && !ov) Error(n, "no overrun in the late pass");
+    printf("adc %d: %u halves, %u read, %u lost, %u overruns\n",
+           n, h, c.Reads, c.Lost, ov);
+  }
+}
+
+//----------------------------------------------------------------------------
+//-------------------------  : ------------------------------
+//----------------------------------------------------------------------------
+
+int main(void)
+{
+  srand(1);
+  Run(0);
+  Run(1);
+  printf("adc: %u errors\n", Errors);
+  return(Errors? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
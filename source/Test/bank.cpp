@@ -0,0 +1,69 @@
+//----------------------------------------------------------------------------
+
+//   TDsBank: ,   ,
+//   ,     
+
+//----------------------------------------------------------------------------
+
+//   0..DAC_MAX_DITH TDitherDac::Fill 
+// Sigma2 (Sigma1  DAC_ORDER 1),    -  Sigma1.
+// ,     
+//Coarse + Fine / DAC_MAX_FINE.  DAC_BANK 0   .
+
+#include "main.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#define private public //  Sigma1, Sigma2
+#include "ditherdac.h"
+#undef private
+
+//----------------------------------------------------------------------------
+
+typedef TDitherDac<0> TDac0;
+
+static union //    
+{
+  uint32_t Words[DAC_MAX_FINE * DAC_STEP / 2];
+  uint16_t Table[DAC_MAX_FINE * DAC_STEP];
+} Bank, Ref;
+
+//----------------------------------------------------------------------------
+
+int main(void)
+{
+  uint32_t Checks = 0, Errors = 0;
+  for(uint32_t v = 0; v <= DAC_MAX_DITH; v++)
+    {
+      uint16_t c = v >> (DAC_RES - DAC_NR);
+      uint16_t f = v & (DAC_MAX_FINE - 1);
+      TDac0::Fill(Bank.Table, c, f);
+      bool Edge = DAC_ORDER == 1 || !c || c >= (1 << DAC_NR) - 2;
+      if(Edge) TDac0::Sigma1(Ref.Table, c, f);
+        else TDac0::Sigma2(Ref.Table, c, f);
+      uint32_t Sum = 0;
+      for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+      {
+        uint16_t b = Bank.Table[i * DAC_STEP];
+        uint16_t r = Ref.Table[i * DAC_STEP];
+        Sum += b;
+        Checks++;
+        if(b != r || b >= (1 << DAC_NR))
+        {
+          if(Errors < 10)
+            printf("c=%u f=%u i=%u: bank %u, sigma %u\n", c, f, i, b, r);
+          Errors++;
+        }
+      }
+      if(Sum != v)
+      {
+        if(Errors < 10) printf("c=%u f=%u: sum %u\n", c, f, Sum);
+        Errors++;
+      }
+    }
+  printf("bank: %u checks, %u errors (DAC_RES %u, DAC_ORDER %u, "
+         "DAC_BANK %u)\n", Checks, Errors, DAC_RES, DAC_ORDER, DAC_BANK);
+  return(Errors? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------
+
+// TFuse:       
+//     t = B / (I^2 - Ilim^2)
+
+//----------------------------------------------------------------------------
+
+//   Ilim,  B   I > Ilim  
+//       .   n,
+//   ,    ,  
+//   t: n - 1 < t <= n (t  , 1  / ADC_BPM).
+//    ,     ,
+//     .
+
+#include "main.h"
+#include "analog.h"
+#include <stdio.h>
+
+//----------------------------- : -----------------------------------
+
+#define TMAX_BLK 200000 //  , 
+#define EPS      1e-9   //   , 
+
+//----------------------------- : ----------------------------------
+
+static uint32_t Checks = 0;
+static uint32_t Errors = 0;
+
+//------------------------  : ------------------------------
+
+static void Check(bool ok, const char *s, uint16_t lim, uint16_t b,
+                  uint16_t i, uint32_t n, double t)
+{
+  Checks++;
+  if(!ok && Errors++ < 10)
+    printf("%s: Ilim %u mA, B %u, I %u mA: block %u, curve %.3f\n",
+           s, lim, b, i, n, t);
+}
+
+//-----------------    : ----------------------
+
+static void Curve(uint16_t lim, uint16_t b, uint16_t i)
+{
+  double a = i / 1000.0, l = lim / 1000.0;
+  double t = b * 0.01 / (a * a - l * l) * 1000.0 * ADC_BPM;
+  if(t > TMAX_BLK) return;
+  TFuse f;
+  f.Set(lim, b);
+  f.Reset();
+  uint32_t n = 1;
+  while(!f.Update(i) && n <= TMAX_BLK) n++;
+  Check(n - 1 < t - EPS && t <= n + EPS, "curve", lim, b, i, n, t);
+}
+
+//----------------------------------------------------------------------------
+//-------------------------  : ------------------------------
+//----------------------------------------------------------------------------
+
+int main(void)
+{
+  //,    t   (Ilim, B, I):
+  static const uint16_t Exact[][3] =
+    { { 0, 1, 1000 }, { 500, 15, 1000 }, { 1000, 3, 2000 },
+      { 3000, 40, 5000 } };
+  for(char k = 0; k < 4; k++)
+    Curve(Exact[k][0], Exact[k][1], Exact[k][2]);
+  // ,   :
+  for(uint16_t lim = 100; lim <= 4000; lim += 390)
+    for(uint16_t b = 1; b <= I2TMAX; b = b * 3 + 1)
+      for(uint16_t i = lim + 1; i <= IMAX; i += 173)
+        Curve(lim, b, i);
+  TFuse f;
+  //:      Ilim^2 - I^2  :
+  f.Set(1000, 100);
+  f.Reset();
+  for(uint16_t k = 0; k < 100; k++) f.Update(2000);
+  uint64_t acc = f.Acc;
+  for(uint16_t k = 0; k < 10; k++) f.Update(500);
+  Check(f.Acc == acc - 10 * 750000ULL, "cooling", 1000, 100, 500, 10, 0);
+  for(uint16_t k = 0; k < 1000; k++) f.Update(0);
+  Check(f.Acc == 0, "cooling to zero", 1000, 100, 0, 1000, 0);
+  //  -  :
+  f.Set(1000, 0);
+  f.Reset();
+  Check(!f.Enabled() && !f.Update(IMAX), "off", 1000, 0, IMAX, 1, 0);
+  printf("fuse: %u checks, %u errors\n", Checks, Errors);
+  return(Errors? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------
+
+//   TDitherDac    :
+//        
+// ,  DAC_ORDER     
+//  
+
+//----------------------------------------------------------------------------
+
+//   DAC_RES 16 (noise16)  20 (noise20). 
+//  (DAC_MAX_FINE    DAC_FS), 
+//  -  k * DAC_FS / DAC_MAX_FINE.   
+//   DFT      
+//(, |H|^2 = 1 / (1 + (f / FC)^4))    FC_LO
+// FC_HI.  -       
+//(12 ):    (  )  . 
+//,      Coarse + Fine / DAC_MAX_FINE.
+//  -v     .
+
+#include "main.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#define private public //  Sigma1, Sigma2
+#include "ditherdac.h"
+#undef private
+
+//----------------------------- : -----------------------------------
+
+#define COARSE 2048  //   ( )
+#define FC_LO  1000  //  , Hz
+#define FC_HI  5000  //  , Hz
+
+//----------------------------------------------------------------------------
+
+typedef TDitherDac<0> TDac0;
+
+static uint16_t Table[DAC_MAX_FINE * DAC_STEP];
+static uint32_t Errors;
+
+//------------------------    : --------------------------
+
+//        fc, LSB.
+
+static double Noise(double fc)
+{
+  const double pi = 3.14159265358979323846;
+  double Mean = 0;
+  for(uint16_t i = 0; i < DAC_MAX_FINE; i++) Mean += Table[i * DAC_STEP];
+  Mean /= DAC_MAX_FINE;
+  double Pwr = 0;
+  for(uint16_t k = 1; k <= DAC_MAX_FINE / 2; k++)
+  {
+    double Re = 0, Im = 0;
+    for(uint16_t i = 0; i < DAC_MAX_FINE; i++)
+    {
+      double e = Table[i * DAC_STEP] - Mean;
+      Re += e * cos(2 * pi * k * i / DAC_MAX_FINE);
+      Im -= e * sin(2 * pi * k * i / DAC_MAX_FINE);
+    }
+    //  (k  DAC_MAX_FINE - k,  ):
+    double p = (Re * Re + Im * Im) / DAC_MAX_FINE / DAC_MAX_FINE;
+    if(k < DAC_MAX_FINE / 2) p *= 2;
+    double r = (double)k * DAC_FS / DAC_MAX_FINE / fc;
+    Pwr += p / (1 + r * r * r * r);
+  }
+  return(sqrt(Pwr));
+}
+
+//------------------------    : --------------------------
+
+struct TResult
+{
+  double Max[2], Avg[2];
+  uint16_t Worst[2];
+};
+
+static TResult Measure(char Order, bool Verbose)
+{
+  TResult r;
+  memset(&r, 0, sizeof(r));
+  for(uint16_t f = 0; f < DAC_MAX_FINE; f++)
+  {
+    if(Order == 2) TDac0::Sigma2(Table, COARSE, f);
+      else TDac0::Sigma1(Table, COARSE, f);
+    uint32_t Sum = 0;
+    for(uint16_t i = 0; i < DAC_MAX_FINE; i++) Sum += Table[i * DAC_STEP];
+    if(Sum != (uint32_t)COARSE * DAC_MAX_FINE + f)
+    {
+      if(Errors++ < 10) printf("order %d, fine %u: wrong mean\n", Order, f);
+    }
+    double n[2] = { Noise(FC_LO), Noise(FC_HI) };
+    for(char j = 0; j < 2; j++)
+    {
+      r.Avg[j] += n[j] / DAC_MAX_FINE;
+      if(n[j] > r.Max[j]) { r.Max[j] = n[j]; r.Worst[j] = f; }
+    }
+    if(Verbose)
+      printf("order %d, fine %3u: %.2e %.2e\n", Order, f, n[0], n[1]);
+  }
+  return(r);
+}
+
+//----------------------------------------------------------------------------
+//-------------------------  : ------------------------------
+//----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+  bool v = argc > 1 && !strcmp(argv[1], "-v");
+  TResult r[2] = { Measure(1, v), Measure(2, v) };
+  const uint16_t fc[2] = { FC_LO, FC_HI };
+  for(char j = 0; j < 2; j++)
+    for(char o = 0; o < 2; o++)
+      printf("noise: DAC_RES %d, fc %u Hz, order %d: max %.2e LSB "
+             "(fine %u), mean %.2e LSB\n", DAC_RES, fc[j], o + 1,
+             r[o].Max[j], r[o].Worst[j], r[o].Avg[j]);
+  //         
+  //(     ):
+  char s = DAC_ORDER - 1;
+  for(char j = 0; j < 2; j++)
+    if(r[s].Max[j] > r[!s].Max[j])
+    {
+      printf("noise: DAC_ORDER %d is noisier at %u Hz\n", DAC_ORDER, fc[j]);
+      Errors++;
+    }
+  printf("noise: %u errors\n", Errors);
+  return(Errors? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+
+// TScaler  TRecip:      
+//       65536   ,
+//       
+// 
+
+//----------------------------------------------------------------------------
+
+#include "main.h"
+#include "analog.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//----------------------------- : -----------------------------------
+
+#define SCALE ((1LL << (64 - 16 - 1)) / VMAX) //  analog.cpp
+#define CALS 200 //  
+#define CORRS 50 //   
+#define EDGE 1024 //   (  )
+
+typedef __int128 int128_t;
+
+//----------------------------- : ----------------------------------
+
+static int64_t Kx;
+static int64_t Sx;
+static uint32_t Checks = 0;
+static uint32_t Errors = 0;
+
+//------------------------  : ------------------------------
+
+static void Check(const char *f, uint32_t x, uint32_t r, uint32_t e)
+{
+  Checks++;
+  if(r != e && Errors++ < 10)
+    printf("%s(%u) = %u, expected %u (Kx = %lld, Sx = %lld)\n",
+           f, x, r, e, (long long)Kx, (long long)Sx);
+}
+
+//-------------- :     : ---------------
+
+static uint32_t Clamp(int128_t n, int128_t d, uint32_t max)
+{
+  if(n < 0) return(0);
+  n /= d;
+  return((n > max)? max : (uint32_t)n);
+}
+
+static void RefCalibrate(uint16_t p1, uint16_t c1,
+                         uint16_t p2, uint16_t c2)
+{
+  uint16_t dp = p2 - p1;
+  uint16_t dc = c2 - c1;
+  Kx = (SCALE * dp + dc / 2) / dc;
+  Sx = Kx * c1 - SCALE * p1;
+}
+
+static uint32_t RefCodeToValue(uint16_t code)
+{
+  return(Clamp((int128_t)Kx * code - Sx + SCALE / 2, SCALE, VMAX));
+}
+
+static uint32_t RefSpanToValue(uint16_t span)
+{
+  return(Clamp((int128_t)Kx * span + SCALE / 2, SCALE, VMAX));
+}
+
+static uint32_t RefValueToCode(uint16_t value)
+{
+  return(Clamp((int128_t)SCALE * value + Sx + Kx / 2, Kx, DAC_MAX_CODE));
+}
+
+static uint32_t RefValueToDac(uint16_t value)
+{
+  int128_t n = (int128_t)SCALE * value + Sx;
+  if(n < 0) return(0);
+  return(Clamp(n * (1 << DAC_EXT) + Kx / 2, Kx, DAC_MAX_DITH));
+}
+
+//----------------------   : --------------------------
+
+static void TestCal(uint16_t p1, uint16_t c1, uint16_t p2, uint16_t c2)
+{
+  TScaler s;
+  s.Calibrate(p1, c1, p2, c2);
+  RefCalibrate(p1, c1, p2, c2);
+  for(uint32_t x = 0; x <= 0xFFFF; x++)
+  {
+    Check("CodeToValue", x, s.CodeToValue(x), RefCodeToValue(x));
+    Check("SpanToValue", x, s.SpanToValue(x), RefSpanToValue(x));
+    Check("ValueToCode", x, s.ValueToCode(x), RefValueToCode(x));
+    Check("ValueToDac", x, s.ValueToDac(x), RefValueToDac(x));
+  }
+}
+
+//-------------     (ValueToCode): ---------------
+
+// ,       ,
+//CodeToValue(ValueToCode(v))    v   
+// .
+
+static void TestCorr(void)
+{
+  for(uint16_t k = 0; k < CORRS; k++)
+  {
+    TScaler s(1);
+    uint16_t p1 = rand() % (VMAX / 4);
+    uint16_t p2 = VMAX - rand() % (VMAX / 4);
+    uint16_t c1 = 1000 + rand() % 8000;
+    uint16_t c2 = 0xFFFF - 1000 - rand() % 8000;
+    s.Calibrate(p1, c1, p2, c2);
+    int8_t t[CORR_PTS];
+    for(char i = 0; i < CORR_PTS; i++)
+      t[i] = (k < 2)? (k? 127 : -128) : rand() % 256 - 128;
+    s.SetCorr(t);
+    s.SetOffset(rand() % 1001 - 500);
+    for(uint16_t v = 0; v <= VMAX; v++)
+    {
+      uint16_t c = s.ValueToCode(v);
+      if(c < EDGE || c > 0xFFFF - EDGE) continue;
+      int32_t d = (int32_t)s.CodeToValue(c) - v;
+      Check("CodeToValue(ValueToCode)", v, (d < -1 || d > 1)? d : 0, 0);
+    }
+  }
+}
+
+//------------------  TRecip   : ------------------
+
+static uint64_t Rand64(void)
+{
+  uint64_t r = 0;
+  for(char k = 0; k < 4; k++)
+    r = (r << 16) ^ (rand() & 0xFFFF);
+  return(r);
+}
+
+static void TestRecip(void)
+{
+  for(uint8_t b = 1; b <= 48; b++)
+  {
+    for(uint16_t k = 0; k < 2000; k++)
+    {
+      uint64_t d = (Rand64() >> (64 - b)) | (1ULL << (b - 1));
+      TRecip r;
+      r.Init(d, 16);
+      //  16 ,  :
+      uint64_t q = (k < 2)? k * 0xFFFF : Rand64() & 0xFFFF;
+      uint64_t n = q * d + Rand64() % d;
+      Check("TRecip::Div", b, r.Div(n), n / d);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+//-------------------------  : ------------------------------
+//----------------------------------------------------------------------------
+
+int main(void)
+{
+  srand(1);
+  //   :
+  TestCal(VMAX / 10, 6000, VMAX * 9 / 10, 58000);
+  TestCal(0, 0, VMAX, 0xFFFF);
+  TestCal(0, 0, 1, 0xFFFF);
+  TestCal(0, 0, VMAX, 1);
+  TestCal(VMAX / 2, 30000, VMAX / 2 + 1, 30001);
+  // :
+  for(uint16_t k = 0; k < CALS; k++)
+  {
+    uint16_t p1 = rand() % (VMAX / 2);
+    uint16_t p2 = p1 + 1 + rand() % (VMAX - p1);
+    uint16_t c1 = rand() % 0x8000;
+    uint16_t c2 = c1 + 1 + rand() % (0xFFFF - c1);
+    TestCal(p1, c1, p2, c2);
+  }
+  TestCorr();
+  TestRecip();
+  printf("scaler: %u checks, %u errors\n", Checks, Errors);
+  return(Errors? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
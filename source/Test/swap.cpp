@@ -0,0 +1,277 @@
+//----------------------------------------------------------------------------
+
+//   TDitherDac:  ,  DMA,
+//         
+
+//----------------------------------------------------------------------------
+
+// DMA   TIM3  :  
+//     CYC , DMA    
+// UNITS  ( CC3  TIM3->CNT = 0).  
+// (TC)  NVIC  ,   Swap
+//    0  LAT_MAX  ( 3  ),
+//     .    
+//,         
+//(   TCIE   Swap).
+//   ,   .
+//       (  
+//   ,   ),  
+//      .
+//        DMA.
+
+#include "main.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+//----------------------------- : -----------------------------------
+
+#define LOADS  200000 //   
+#define UNITS      30 //     
+#define LAT_MAX (3 * UNITS) //   
+#define SETTLE     50 //    
+
+//--------------------------   DMA: ---------------------------
+
+static void Tick(void);
+static void Written(void);
+static uint32_t Phase(void);
+
+struct TReg
+{
+  uint32_t V;
+  operator uint32_t() { Tick(); return(V); }
+  TReg &operator = (uint32_t v) { Tick(); V = v; Written(); return(*this); }
+  TReg &operator |= (uint32_t v) { return(*this = V | v); }
+  TReg &operator &= (uint32_t v) { return(*this = V & v); }
+};
+
+struct THostChannel { TReg CCR, CNDTR, CPAR, CMAR; };
+struct THostDma { TReg ISR, IFCR; };
+
+static THostDma Dma;
+static THostChannel Ch2;
+static uint32_t Now; //,   
+
+// TIM3:     .
+
+struct TTimCnt
+{
+  operator uint32_t() { Tick(); return(Phase()); }
+};
+
+struct THostTim { uint32_t CR1, DIER, PSC, ARR, CCR3, CCR4; TTimCnt CNT; };
+
+static THostTim Tim3;
+
+#undef DMA1
+#undef DMA1_Channel2
+#undef DMA1_Channel3
+#undef TIM3
+#define DMA1 (&Dma)
+#define DMA1_Channel2 (&Ch2)
+#define DMA1_Channel3 (&Ch2)
+#define TIM3 (&Tim3)
+
+#define private public //    Swap
+#include "ditherdac.h"
+#undef private
+
+//----------------------------- : ----------------------------------
+
+static TDitherDac<0> Dac;
+static bool IgnoreMask;     //   
+static bool NvicPending;    //   NVIC
+static uint32_t Due;        //  
+static bool InIsr;
+static bool InProt;         //  
+static uint32_t Latest;     //  
+static bool En;             //  EN 
+static uint16_t *Cur;       //,    DMA
+static uint16_t Pos;        //   
+static bool Torn;           //    
+static uint16_t Start[DAC_MAX_FINE];  //   
+static uint16_t Period[DAC_MAX_FINE]; // 
+static uint16_t Done[2][DAC_MAX_FINE]; //  
+static uint32_t Periods;
+static uint32_t Late;       //,  - 
+static uint32_t Errors;
+
+//-------------------------   : ---------------------------
+
+static uint32_t Phase(void)
+{
+  return(Now % UNITS * (DAC_PER / UNITS));
+}
+
+//------------------------    CMAR: ---------------------------
+
+//  CMAR   32 ,     .
+
+static uint16_t *Table(uint32_t a)
+{
+  for(char k = 0; k < 2; k++)
+    if((uint32_t)(uintptr_t)Dac.DitherTable[k] == a)
+      return(Dac.DitherTable[k]);
+  return(0);
+}
+
+//----------------------------  : -------------------------------
+
+static void Error(const char *s)
+{
+  if(Errors++ < 10) printf("period %u: %s\n", Periods, s);
+}
+
+//------------------------   DMA: ----------------------------
+
+static void Raise(void)
+{
+  if(NvicPending) return;
+  NvicPending = 1;
+  Due = Now + rand() % (LAT_MAX + 1);
+}
+
+//---------------------------  : --------------------------------
+
+//    ,    (
+// ),      .
+
+static void Emit(void)
+{
+  if(!En || !Cur) return;
+  if(!Pos)
+  {
+    if(memcmp(Cur, Done[Cur == Dac.DitherTable[1]], sizeof(Start)))
+      Error("table is not completely loaded");
+    memcpy(Start, Cur, sizeof(Start));
+  }
+  Period[Pos] = Cur[Pos];
+  Ch2.CNDTR.V = DAC_MAX_FINE - 1 - Pos;
+  if(++Pos < DAC_MAX_FINE) return;
+  Periods++;
+  if(Torn) Error("restarted in the middle");
+  if(memcmp(Period, Start, sizeof(Period)))
+    Error("table changed during the period");
+  Torn = 0;
+  Pos = 0; // :   
+  Ch2.CNDTR.V = DAC_MAX_FINE;
+  Dma.ISR.V |= DMA_ISR_TCIF2;
+  if(Ch2.CCR.V & DMA_CCR2_TCIE) Raise();
+}
+
+//------------------------------ : -----------------------------------
+
+//   (    )
+//   ,   
+//Active,      .
+
+static void Load(uint32_t v)
+{
+  Latest = v;
+  Dac = v;
+  if(TDitherDac<0>::Busy) return;
+  uint32_t w[DAC_MAX_FINE / 2];
+  uint16_t *t = (uint16_t *)w;
+  TDitherDac<0>::Fill(t, Latest >> (DAC_RES - DAC_NR),
+                      Latest & (DAC_MAX_FINE - 1));
+  uint16_t *a = Dac.DitherTable[Dac.Active];
+  if(memcmp(a, t, sizeof(w))) Error("table does not hold the last code");
+  memcpy(Done[Dac.Active], a, sizeof(Done[0]));
+}
+
+//------------------     : ------------------
+
+//DMA     ,    .
+
+static void Tick(void)
+{
+  if(++Now % UNITS == 0) Emit();
+  if(InIsr) return;
+  if(NvicPending && Now >= Due && (IgnoreMask || !HostPrimask))
+  {
+    InIsr = 1;
+    NvicPending = 0;
+    bool p = TDitherDac<0>::Pending;
+    TDitherDac<0>::Swap();
+    if(p && TDitherDac<0>::Pending && !(Dma.ISR.V & DMA_ISR_TCIF2)) Late++;
+    InIsr = 0;
+  }
+  //  (   ):
+  if(!InProt && !HostPrimask && rand() % 64 == 0)
+  {
+    InProt = 1;
+    Load(rand() % 2? 0 : rand() % (DAC_MAX_DITH + 1));
+    InProt = 0;
+  }
+}
+
+//-------------------------  : --------------------------------
+
+static void Written(void)
+{
+  if(Dma.IFCR.V)
+  {
+    Dma.ISR.V &= ~Dma.IFCR.V;
+    Dma.IFCR.V = 0;
+  }
+  bool en = Ch2.CCR.V & DMA_CCR2_EN;
+  if(en && !En)
+  {
+    //    :
+    if(Pos) Torn = 1;
+    Pos = 0;
+    Cur = Table(Ch2.CMAR.V);
+  }
+  En = en;
+  //  -  TCIF & TCIE:
+  if((Ch2.CCR.V & DMA_CCR2_TCIE) && (Dma.ISR.V & DMA_ISR_TCIF2)) Raise();
+}
+
+//-------------------------   : -------------------------------
+
+static void Run(bool ignore)
+{
+  IgnoreMask = ignore;
+  memset(Dac.DitherTable, 0, sizeof(Dac.DitherTable));
+  memset(Done, 0, sizeof(Done));
+  Dac.Active = 0;
+  TDitherDac<0>::Pending = 0;
+  Dma.ISR.V = 0;
+  NvicPending = 0;
+  Ch2.CMAR.V = (uint32_t)(uintptr_t)Dac.DitherTable[0];
+  Ch2.CNDTR.V = DAC_MAX_FINE;
+  Ch2.CCR.V = 0;
+  En = 0;
+  Pos = 0;
+  Torn = 0;
+  Ch2.CCR = DMA_CCR2_CIRC | DMA_CCR2_EN;
+  for(uint32_t n = 0; n < LOADS; n++)
+  {
+    for(uint16_t k = rand() % 400; k; k--) Tick();
+    Load(rand() % (DAC_MAX_DITH + 1));
+  }
+  //  DMA      :
+  InProt = 1;
+  for(uint32_t k = 0; k < SETTLE * DAC_MAX_FINE * UNITS; k++) Tick();
+  InProt = 0;
+  if(TDitherDac<0>::Pending || Cur != Dac.DitherTable[Dac.Active])
+    Error("the last code is not output");
+}
+
+//----------------------------------------------------------------------------
+//-------------------------  : ------------------------------
+//----------------------------------------------------------------------------
+
+int main(void)
+{
+  srand(1);
+  HostIrq = Tick; //    
+  Run(0);
+  Run(1);
+  printf("swap: %u periods, %u late, %u errors\n", Periods, Late, Errors);
+  return(Errors? 1 : 0);
+}
+
+//----------------------------------------------------------------------------
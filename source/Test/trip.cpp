@@ -0,0 +1,91 @@
+//----------------------------------------------------------------------------
+
+// TScaler::ValueToTrip:       
+// ,   ,   CodeToValue
+
+//----------------------------------------------------------------------------
+
+//  ,      
+//CodeToValue   65536 . ,  CodeToValue
+//  (      ),
+//     0..VMAX + 1 ValueToTrip   ,
+//  CodeToValue >= ,  PROT_OFF,   .
+
+#include "main.h"
+#include "analog.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//----------------------------- : -----------------------------------
+
+#define CALS 100 //  
+
+//----------------------------- : ----------------------------------
+
+static uint16_t Cv[0x10000];
+static uint32_t Checks = 0;
+static uint32_t Errors = 0;
+
+//------------------------  : ------------------------------
+
+static void Check(const char *f, uint32_t x, uint32_t r, uint32_t e)
+{
+  Checks++;
+  if(r != e && Errors++ < 10)
+    printf("%s(%u) = %u, expected %u\n", f, x, r, e);
+}
+
+//----------------------   : --------------------------
+
+static void TestCal(uint16_t p1, uint16_t c1, uint16_t p2, uint16_t c2,
+                    const int8_t *corr, int16_t offset)
+{
+  TScaler s;
+  s.Calibrate(p1, c1, p2, c2);
+  s.SetCorr(corr);
+  s.SetOffset(offset);
+  for(uint32_t x = 0; x <= 0xFFFF; x++)
+  {
+    Cv[x] = s.CodeToValue(x);
+    if(x) Check("monotonic", x, Cv[x] >= Cv[x - 1], 1);
+  }
+  //   Cv >= v, :
+  uint32_t c = 0;
+  for(uint32_t v = 0; v <= VMAX + 1; v++)
+  {
+    while(c <= 0xFFFF && Cv[c] < v) c++;
+    Check("ValueToTrip", v, s.ValueToTrip(v), (c > 0xFFFF)? PROT_OFF : c);
+  }
+}
+
+//----------------------------------------------------------------------------
+//-------------------------  : ------------------------------
+//----------------------------------------------------------------------------
+
+int main(void)
+{
+  static const int8_t Zero[CORR_PTS] = { 0 };
+  int8_t Corr[CORR_PTS];
+  srand(1);
+  //   :
+  TestCal(VMAX / 10, 6000, VMAX * 9 / 10, 58000, Zero, 0);
+  TestCal(0, 0, VMAX, 0xFFFF, Zero, 0);
+  TestCal(0, 0, 1, 0xFFFF, Zero, 0);
+  TestCal(0, 0, VMAX, 1, Zero, 0);
+  // ,     :
+  for(uint16_t k = 0; k < CALS; k++)
+  {
+    uint16_t p1 = rand() % (VMAX / 2);
+    uint16_t p2 = p1 + 1 + rand() % (VMAX - p1);
+    uint16_t c1 = rand() % 0x8000;
+    uint16_t c2 = c1 + 1 + rand() % (0xFFFF - c1);
+    for(char i = 0; i < CORR_PTS; i++)
+      Corr[i] = (k & 1)? rand() % 255 - 127 : 0;
+    int16_t o = (k & 2)? rand() % 401 - 200 : 0;
+    TestCal(p1, c1, p2, c2, Corr, o);
+  }
+  printf("trip: %u checks, %u errors\n", Checks, Errors);
+  return(Errors? 1 : 0);
+}
+
+//----------------------------------------------------------------------------